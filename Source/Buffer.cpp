@@ -10,7 +10,6 @@ juce::OpenGLContext* Buffer::getContext()
 void Buffer::setGLStates()
 {
 	juce::gl::glEnable(juce::gl::GL_BLEND);
-	juce::gl::glEnable(juce::gl::GL_LINE_SMOOTH);
 	juce::gl::glBlendFunc(juce::gl::GL_SRC_ALPHA, juce::gl::GL_ONE_MINUS_SRC_ALPHA);
 }
 
@@ -38,6 +37,18 @@ Buffer::Buffer()
 	vbos[colourBuffer] = 0;
 	vbos[textureBuffer] = 0;
 	vbos[normalBuffer] = 0;
+
+	streamRing = 0;
+	streamFrame = 0;
+	streamFrameSize = 0;
+	streamFrameUsed = 0;
+	streamMode = StreamMode::orphaning;
+	persistentMemory = nullptr;
+
+	for (auto& fence : streamFences)
+	{
+		fence = nullptr;
+	}
 }
 
 void Buffer::create(GLuint totalVertices, bool hasEbo)
@@ -71,17 +82,192 @@ void Buffer::appendVbo(Vbo vbo, GLfloat* data, GLsizeiptr size, GLuint offset)
 	glContext->extensions.glBufferSubData(juce::gl::GL_ARRAY_BUFFER, offset, size, data);
 }
 
+void Buffer::resizeVbo(Vbo vbo, GLsizeiptr keptSize, GLsizeiptr newSize, Fill fill)
+{
+	//Storage cannot grow in place, so the kept part is copied on the GPU
+	//into a new buffer, which then takes over the old one's slot
+	GLuint resized = 0;
+	glContext->extensions.glGenBuffers(1, &resized);
+	glContext->extensions.glBindBuffer(juce::gl::GL_COPY_WRITE_BUFFER, resized);
+	glContext->extensions.glBufferData(juce::gl::GL_COPY_WRITE_BUFFER, newSize, nullptr, static_cast<GLenum> (fill));
+
+	if (keptSize > 0)
+	{
+		glContext->extensions.glBindBuffer(juce::gl::GL_COPY_READ_BUFFER, vbos[vbo]);
+		juce::gl::glCopyBufferSubData(juce::gl::GL_COPY_READ_BUFFER, juce::gl::GL_COPY_WRITE_BUFFER, 0, 0, juce::jmin(keptSize, newSize));
+	}
+
+	glContext->extensions.glDeleteBuffers(1, &vbos[vbo]);
+	vbos[vbo] = resized;
+}
+
+void Buffer::createStream(GLsizeiptr maxBytesPerFrame)
+{
+	//New data is written into one of several per-frame regions of a staging
+	//ring and copied into place on the GPU. Writing straight into a VBO that
+	//the previous frame is still drawing from would make the driver stall
+	streamFrameSize = maxBytesPerFrame;
+	streamFrameUsed = 0;
+	streamFrame = 0;
+
+	const auto ringSize = streamFrameSize * maxStreamFrames;
+	const auto hasFences = juce::gl::glFenceSync != nullptr && juce::gl::glClientWaitSync != nullptr;
+
+	glContext->extensions.glGenBuffers(1, &streamRing);
+	glContext->extensions.glBindBuffer(juce::gl::GL_COPY_WRITE_BUFFER, streamRing);
+
+	if (hasFences && juce::gl::glBufferStorage != nullptr && isBufferStorageSupported())
+	{
+		const GLbitfield flags = juce::gl::GL_MAP_WRITE_BIT | juce::gl::GL_MAP_PERSISTENT_BIT | juce::gl::GL_MAP_COHERENT_BIT;
+
+		juce::gl::glBufferStorage(juce::gl::GL_COPY_WRITE_BUFFER, ringSize, nullptr, flags);
+		persistentMemory = static_cast<GLubyte*> (juce::gl::glMapBufferRange(juce::gl::GL_COPY_WRITE_BUFFER, 0, ringSize, flags));
+		streamMode = StreamMode::persistent;
+
+		//Storage made by glBufferStorage can never be respecified, so a
+		//failed map needs a fresh buffer before falling back to glBufferData
+		if (persistentMemory == nullptr)
+		{
+			glContext->extensions.glDeleteBuffers(1, &streamRing);
+			glContext->extensions.glGenBuffers(1, &streamRing);
+			glContext->extensions.glBindBuffer(juce::gl::GL_COPY_WRITE_BUFFER, streamRing);
+		}
+	}
+
+	if (persistentMemory == nullptr)
+	{
+		glContext->extensions.glBufferData(juce::gl::GL_COPY_WRITE_BUFFER, ringSize, nullptr, juce::gl::GL_STREAM_DRAW);
+		streamMode = (hasFences && juce::gl::glMapBufferRange != nullptr) ? StreamMode::unsynchronised : StreamMode::orphaning;
+	}
+}
+
+bool Buffer::isBufferStorageSupported()
+{
+	//Core profiles no longer accept GL_EXTENSIONS in glGetString, so we
+	//check the version first and then walk the indexed extension list
+	GLint majorVersion = 0;
+	GLint minorVersion = 0;
+	juce::gl::glGetIntegerv(juce::gl::GL_MAJOR_VERSION, &majorVersion);
+	juce::gl::glGetIntegerv(juce::gl::GL_MINOR_VERSION, &minorVersion);
+
+	if (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 4))
+	{
+		return true;
+	}
+
+	GLint totalExtensions = 0;
+	juce::gl::glGetIntegerv(juce::gl::GL_NUM_EXTENSIONS, &totalExtensions);
+
+	for (GLint i = 0; i < totalExtensions; i++)
+	{
+		auto* extension = reinterpret_cast<const char*> (juce::gl::glGetStringi(juce::gl::GL_EXTENSIONS, static_cast<GLuint> (i)));
+
+		if (extension != nullptr && std::strcmp(extension, "GL_ARB_buffer_storage") == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Buffer::waitForStreamFrame()
+{
+	//The fence was placed the last time this region was used, several frames
+	//ago, so by now it has almost always been signalled already
+	auto& fence = streamFences[streamFrame];
+
+	if (fence != nullptr)
+	{
+		juce::gl::glClientWaitSync(fence, juce::gl::GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		juce::gl::glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+void Buffer::streamVbo(Vbo vbo, const GLfloat* data, GLsizeiptr size, GLintptr offset)
+{
+	//Writing past the frame's region would run off the end of the ring
+	if (streamFrameUsed + size > streamFrameSize)
+	{
+		jassertfalse;
+		return;
+	}
+
+	if (streamFrameUsed == 0)
+	{
+		waitForStreamFrame();
+	}
+
+	const auto ringOffset = streamFrame * streamFrameSize + streamFrameUsed;
+
+	glContext->extensions.glBindBuffer(juce::gl::GL_COPY_READ_BUFFER, streamRing);
+
+	if (streamMode == StreamMode::persistent)
+	{
+		std::memcpy(persistentMemory + ringOffset, data, static_cast<size_t> (size));
+	}
+
+	else if (streamMode == StreamMode::unsynchronised)
+	{
+		const GLbitfield flags = juce::gl::GL_MAP_WRITE_BIT | juce::gl::GL_MAP_UNSYNCHRONIZED_BIT | juce::gl::GL_MAP_INVALIDATE_RANGE_BIT;
+
+		if (auto* memory = juce::gl::glMapBufferRange(juce::gl::GL_COPY_READ_BUFFER, ringOffset, size, flags))
+		{
+			std::memcpy(memory, data, static_cast<size_t> (size));
+			juce::gl::glUnmapBuffer(juce::gl::GL_COPY_READ_BUFFER);
+		}
+	}
+
+	else
+	{
+		//Orphan the ring at the start of each frame so the driver can hand
+		//us fresh storage instead of waiting for the GPU to release the old
+		if (streamFrameUsed == 0)
+		{
+			glContext->extensions.glBufferData(juce::gl::GL_COPY_READ_BUFFER, streamFrameSize * maxStreamFrames, nullptr, juce::gl::GL_STREAM_DRAW);
+		}
+
+		glContext->extensions.glBufferSubData(juce::gl::GL_COPY_READ_BUFFER, ringOffset, size, data);
+	}
+
+	glContext->extensions.glBindBuffer(juce::gl::GL_COPY_WRITE_BUFFER, vbos[vbo]);
+	juce::gl::glCopyBufferSubData(juce::gl::GL_COPY_READ_BUFFER, juce::gl::GL_COPY_WRITE_BUFFER, ringOffset, offset, size);
+
+	streamFrameUsed += size;
+}
+
+void Buffer::endStreamFrame()
+{
+	if (streamMode != StreamMode::orphaning && streamFrameUsed > 0)
+	{
+		streamFences[streamFrame] = juce::gl::glFenceSync(juce::gl::GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	streamFrame = (streamFrame + 1) % maxStreamFrames;
+	streamFrameUsed = 0;
+}
+
+Buffer::StreamMode Buffer::getStreamMode() const
+{
+	return streamMode;
+}
+
 void Buffer::appendEbo(GLuint* data, GLsizeiptr size, GLuint offset)
 {
 	glContext->extensions.glBindBuffer(juce::gl::GL_ELEMENT_ARRAY_BUFFER, ebo);
 	glContext->extensions.glBufferSubData(juce::gl::GL_ELEMENT_ARRAY_BUFFER, offset, size, data);
 }
 
-void Buffer::linkVbo(GLuint attributeID, Vbo vbo, ComponentSize componentSize, DataType dataType)
+void Buffer::linkVbo(GLuint attributeID, Vbo vbo, ComponentSize componentSize, DataType dataType,
+	GLsizeiptr offset, GLuint divisor)
 {
 	glContext->extensions.glBindBuffer(juce::gl::GL_ARRAY_BUFFER, vbos[vbo]);
-	glContext->extensions.glVertexAttribPointer(attributeID, static_cast<GLint> (componentSize), static_cast<GLenum> (dataType), juce::gl::GL_FALSE, 0, nullptr);
+	glContext->extensions.glVertexAttribPointer(attributeID, static_cast<GLint> (componentSize), static_cast<GLenum> (dataType), juce::gl::GL_FALSE, 0, reinterpret_cast<const GLvoid*> (offset));
 	glContext->extensions.glEnableVertexAttribArray(attributeID);
+
+	//A divisor of 1 advances the attribute once per instance instead of once per vertex
+	juce::gl::glVertexAttribDivisor(attributeID, divisor);
 }
 
 void Buffer::disableAttribute(GLuint attributeID)
@@ -105,6 +291,11 @@ void Buffer::render(RenderMode renderMode, GLint index, GLuint maxRenderVertices
 	}
 }
 
+void Buffer::renderInstanced(RenderMode renderMode, GLuint verticesPerInstance, GLuint totalInstances)
+{
+	juce::gl::glDrawArraysInstanced(static_cast<GLenum> (renderMode), 0, static_cast<GLsizei> (verticesPerInstance), static_cast<GLsizei> (totalInstances));
+}
+
 void Buffer::destroy()
 {
 	if (hasEbo)
@@ -113,4 +304,26 @@ void Buffer::destroy()
 	}
 
 	glContext->extensions.glDeleteBuffers(4, vbos);
+
+	if (streamRing != 0)
+	{
+		for (auto& fence : streamFences)
+		{
+			if (fence != nullptr)
+			{
+				juce::gl::glDeleteSync(fence);
+				fence = nullptr;
+			}
+		}
+
+		if (persistentMemory != nullptr)
+		{
+			glContext->extensions.glBindBuffer(juce::gl::GL_COPY_WRITE_BUFFER, streamRing);
+			juce::gl::glUnmapBuffer(juce::gl::GL_COPY_WRITE_BUFFER);
+			persistentMemory = nullptr;
+		}
+
+		glContext->extensions.glDeleteBuffers(1, &streamRing);
+		streamRing = 0;
+	}
 }
\ No newline at end of file
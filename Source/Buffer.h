@@ -42,9 +42,20 @@ public:
 		triangles = juce::gl::GL_TRIANGLES,
 		lines = juce::gl::GL_LINES,
 		lineLoop = juce::gl::GL_LINE_LOOP,
-		lineStrip = juce::gl::GL_LINE_STRIP
+		lineStrip = juce::gl::GL_LINE_STRIP,
+		triangleStrip = juce::gl::GL_TRIANGLE_STRIP
 	};
 
+	//How the streaming ring gets new data to the GPU, best first
+	enum class StreamMode
+	{
+		persistent,
+		unsynchronised,
+		orphaning
+	};
+
+	static const int maxStreamFrames{ 3 };
+
 	Buffer();
 
 	static juce::OpenGLContext* getContext();
@@ -60,12 +71,22 @@ public:
 	void fillEbo(GLuint* data, GLsizeiptr bufferSize, Fill fill = Fill::once);
 	
 	void appendVbo(Vbo vbo, GLfloat* data, GLsizeiptr size, GLuint offset);
+
+	//Gives the VBO new storage of newSize bytes, keeping its first keptSize bytes
+	void resizeVbo(Vbo vbo, GLsizeiptr keptSize, GLsizeiptr newSize, Fill fill = Fill::once);
+
+	void createStream(GLsizeiptr maxBytesPerFrame);
+	void streamVbo(Vbo vbo, const GLfloat* data, GLsizeiptr size, GLintptr offset);
+	void endStreamFrame();
+	StreamMode getStreamMode() const;
 	void appendEbo(GLuint* data, GLsizeiptr size, GLuint offset);
 	
-	void linkVbo(GLuint attributeID, Vbo vbo, ComponentSize componentSize, DataType dataType);
+	void linkVbo(GLuint attributeID, Vbo vbo, ComponentSize componentSize, DataType dataType,
+		GLsizeiptr offset = 0, GLuint divisor = 0);
 	void disableAttribute(GLuint attributeID);
 	
 	void render(RenderMode renderMode, GLint index = 0, GLuint maxRenderVertices = 0);
+	void renderInstanced(RenderMode renderMode, GLuint verticesPerInstance, GLuint totalInstances);
 	void destroy();
 
 private:
@@ -75,5 +96,16 @@ private:
 	GLuint totalVertices;
 	GLuint vbos[4];
 
+	GLuint streamRing;
+	int streamFrame;
+	GLsizeiptr streamFrameSize;
+	GLsizeiptr streamFrameUsed;
+	StreamMode streamMode;
+	GLubyte* persistentMemory;
+	juce::gl::GLsync streamFences[maxStreamFrames];
+
+	void waitForStreamFrame();
+	static bool isBufferStorageSupported();
+
 	static juce::OpenGLContext* glContext;
 };
\ No newline at end of file
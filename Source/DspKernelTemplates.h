@@ -0,0 +1,81 @@
+#pragma once
+
+//The kernel bodies, written once against a Vector type that each variant
+//file defines for its own register width. Only included from those files,
+//and always inside an anonymous namespace, so every variant keeps its own
+//copy. The scalar tails and the vector loops do the same arithmetic in the
+//same order, so gain and saturation give identical results on every variant
+
+#include "FastTanh.h"
+
+template <typename Vector>
+void ApplyGain(float* data, int numSamples, float gain)
+{
+	const auto gainVector = Vector::expand(gain);
+	int sample = 0;
+
+	for (; sample + Vector::width <= numSamples; sample += Vector::width)
+	{
+		(Vector::load(data + sample) * gainVector).store(data + sample);
+	}
+
+	for (; sample < numSamples; ++sample)
+	{
+		data[sample] *= gain;
+	}
+}
+
+template <typename Vector>
+void Saturate(float* data, int numSamples, float driveStart, float driveIncrement,
+	float gainStart, float gainIncrement)
+{
+	const auto lanes = Vector::lanes();
+	int sample = 0;
+
+	for (; sample + Vector::width <= numSamples; sample += Vector::width)
+	{
+		const auto step = Vector::expand(static_cast<float>(sample)) + lanes;
+		const auto drive = Vector::expand(driveStart) + Vector::expand(driveIncrement) * step;
+		const auto gain = Vector::expand(gainStart) + Vector::expand(gainIncrement) * step;
+
+		const auto x = Min(Max(drive * Vector::load(data + sample), Vector::expand(-5.0f)), Vector::expand(5.0f));
+		(gain * Tanh(x)).store(data + sample);
+	}
+
+	for (; sample < numSamples; ++sample)
+	{
+		const auto step = static_cast<float>(sample);
+		auto x = (driveStart + driveIncrement * step) * data[sample];
+		x = x < -5.0f ? -5.0f : (5.0f < x ? 5.0f : x);
+		data[sample] = (gainStart + gainIncrement * step) * TanhScalar(x);
+	}
+}
+
+template <typename Vector>
+void MeasurePeakAndEnergy(const float* data, int numSamples, float* peak, float* sumOfSquares)
+{
+	auto maximumVector = Vector::expand(0.0f);
+	auto squaresVector = Vector::expand(0.0f);
+	int sample = 0;
+
+	for (; sample + Vector::width <= numSamples; sample += Vector::width)
+	{
+		const auto x = Vector::load(data + sample);
+		maximumVector = Max(maximumVector, Abs(x));
+		squaresVector = squaresVector + x * x;
+	}
+
+	auto maximum = maximumVector.maximum();
+	auto squares = squaresVector.sum();
+
+	for (; sample < numSamples; ++sample)
+	{
+		const auto x = data[sample];
+		const auto magnitude = x < 0.0f ? -x : x;
+		maximum = magnitude > maximum ? magnitude : maximum;
+		squares += x * x;
+	}
+
+	*peak = maximum;
+	*sumOfSquares = squares;
+}
\ No newline at end of file
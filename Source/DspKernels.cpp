@@ -0,0 +1,147 @@
+#include "DspKernels.h"
+#include <JuceHeader.h>
+
+#if DSP_KERNELS_X86
+#if JUCE_MSVC
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+#if DSP_KERNELS_X86
+	void Cpuid(unsigned int leaf, unsigned int subleaf, unsigned int* registers)
+	{
+#if JUCE_MSVC
+		int values[4];
+		__cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+
+		for (int i = 0; i < 4; ++i)
+		{
+			registers[i] = static_cast<unsigned int>(values[i]);
+		}
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+
+	//Which register states the operating system saves on a context switch
+	unsigned long long GetEnabledRegisterState()
+	{
+#if JUCE_MSVC
+		return _xgetbv(0);
+#else
+		unsigned int low, high;
+		__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+		return (static_cast<unsigned long long>(high) << 32) | low;
+#endif
+	}
+
+	//CPUID alone is not enough: wide registers are only usable once the
+	//operating system has enabled saving them, which XGETBV reports. The
+	//compiler may also use FMA with /arch:AVX2, and the AVX-512 extensions
+	//that /arch:AVX512 assumes, so those are required too
+	InstructionSet DetectInstructionSet()
+	{
+		unsigned int registers[4];
+		Cpuid(0, 0, registers);
+		const auto maxLeaf = registers[0];
+
+		Cpuid(1, 0, registers);
+		const auto hasFma = (registers[2] & (1u << 12)) != 0;
+		const auto hasXsave = (registers[2] & (1u << 27)) != 0;
+		const auto hasAvx = (registers[2] & (1u << 28)) != 0;
+
+		if (maxLeaf < 7 || !hasXsave || !hasAvx || !hasFma)
+		{
+			return InstructionSet::sse2;
+		}
+
+		const auto registerState = GetEnabledRegisterState();
+
+		//SSE and AVX state
+		if ((registerState & 0x6) != 0x6)
+		{
+			return InstructionSet::sse2;
+		}
+
+		Cpuid(7, 0, registers);
+
+		if ((registers[1] & (1u << 5)) == 0)
+		{
+			return InstructionSet::sse2;
+		}
+
+		//F, DQ, CD, BW and VL, plus the opmask and upper ZMM state
+		const auto avx512Bits = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+
+		if ((registers[1] & avx512Bits) == avx512Bits && (registerState & 0xe6) == 0xe6)
+		{
+			return InstructionSet::avx512;
+		}
+
+		return InstructionSet::avx2;
+	}
+#else
+	InstructionSet DetectInstructionSet()
+	{
+		return InstructionSet::sse2;
+	}
+#endif
+
+	const DspKernels* GetBuiltKernels(InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::sse2: return getSSE2Kernels();
+		case InstructionSet::avx2: return getAVX2Kernels();
+		case InstructionSet::avx512: return getAVX512Kernels();
+		default: return nullptr;
+		}
+	}
+}
+
+InstructionSet DspKernels::getBestSupported()
+{
+	//The processor does not change while the plugin is loaded
+	static const InstructionSet detected = DetectInstructionSet();
+
+	auto best = detected;
+
+	while (best != InstructionSet::sse2 && GetBuiltKernels(best) == nullptr)
+	{
+		best = static_cast<InstructionSet>(static_cast<int>(best) - 1);
+	}
+
+	return best;
+}
+
+bool DspKernels::isSupported(InstructionSet instructionSet)
+{
+	return instructionSet != InstructionSet::automatic
+		&& static_cast<int>(instructionSet) <= static_cast<int>(getBestSupported())
+		&& GetBuiltKernels(instructionSet) != nullptr;
+}
+
+InstructionSet DspKernels::resolve(InstructionSet instructionSet)
+{
+	return isSupported(instructionSet) ? instructionSet : getBestSupported();
+}
+
+const DspKernels& DspKernels::get(InstructionSet instructionSet)
+{
+	return *GetBuiltKernels(resolve(instructionSet));
+}
+
+const char* DspKernels::getName(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+	case InstructionSet::sse2: return "sse2";
+	case InstructionSet::avx2: return "avx2";
+	case InstructionSet::avx512: return "avx512";
+	default: return "automatic";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+//Kept free of JuceHeader.h on purpose. The variant files include this with
+//AVX code generation switched on, and any inline JUCE function compiled
+//there could become the one copy the linker keeps for the whole plugin
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DSP_KERNELS_X86 1
+#else
+#define DSP_KERNELS_X86 0
+#endif
+
+//Instruction sets the kernels are built for, oldest first
+enum class InstructionSet
+{
+	automatic,
+	sse2,
+	avx2,
+	avx512
+};
+
+//The hot loops that vectorise well, built once per instruction set. Each
+//variant lives in its own file compiled for that set, and the processor
+//picks a table once in prepareToPlay, so a single binary runs on any x64
+//machine while still using the widest registers the machine has
+struct DspKernels
+{
+	//data *= gain
+	void (*applyGain)(float* data, int numSamples, float gain);
+
+	//The ladder's input stage, data = gain * tanh(drive * data), with drive
+	//and gain each moving by one increment per sample from their start
+	void (*saturate)(float* data, int numSamples, float driveStart, float driveIncrement,
+		float gainStart, float gainIncrement);
+
+	//Largest absolute sample and the sum of squares
+	void (*measurePeakAndEnergy)(const float* data, int numSamples, float* peak, float* sumOfSquares);
+
+	//The widest set that is built in and that both the processor and the
+	//operating system support
+	static InstructionSet getBestSupported();
+	static bool isSupported(InstructionSet instructionSet);
+
+	//Automatic, or any set this machine cannot run, becomes the best supported
+	static InstructionSet resolve(InstructionSet instructionSet);
+	static const DspKernels& get(InstructionSet instructionSet);
+
+	static const char* getName(InstructionSet instructionSet);
+};
+
+//One per variant file. The AVX ones return nullptr when the build did not
+//compile their file for that instruction set
+const DspKernels* getSSE2Kernels();
+const DspKernels* getAVX2Kernels();
+const DspKernels* getAVX512Kernels();
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "DspKernels.h"
+
+//Compiled with /arch:AVX2 (the "avx2" compiler flag scheme in Plugin.jucer).
+//Without that flag the variant is left out and never selected
+#if DSP_KERNELS_X86 && defined(__AVX2__)
+#include <immintrin.h>
+
+//Fused multiply-adds round differently, so none are formed here either by
+//hand or by the compiler, which keeps the results equal to the SSE2 variant
+#ifdef _MSC_VER
+#pragma fp_contract(off)
+#endif
+
+namespace
+{
+	struct Vector
+	{
+		static const int width{ 8 };
+
+		__m256 value;
+
+		static Vector load(const float* data) { return { _mm256_loadu_ps(data) }; }
+		static Vector expand(float x) { return { _mm256_set1_ps(x) }; }
+		static Vector lanes() { return { _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f) }; }
+		void store(float* data) const { _mm256_storeu_ps(data, value); }
+
+		float sum() const
+		{
+			const auto halves = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+			const auto pairs = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+			return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+		}
+
+		float maximum() const
+		{
+			const auto halves = _mm_max_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+			const auto pairs = _mm_max_ps(halves, _mm_movehl_ps(halves, halves));
+			return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+		}
+	};
+
+	inline Vector operator+(Vector a, Vector b) { return { _mm256_add_ps(a.value, b.value) }; }
+	inline Vector operator*(Vector a, Vector b) { return { _mm256_mul_ps(a.value, b.value) }; }
+	inline Vector operator/(Vector a, Vector b) { return { _mm256_div_ps(a.value, b.value) }; }
+	inline Vector Min(Vector a, Vector b) { return { _mm256_min_ps(a.value, b.value) }; }
+	inline Vector Max(Vector a, Vector b) { return { _mm256_max_ps(a.value, b.value) }; }
+	inline Vector Abs(Vector a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value) }; }
+
+#include "DspKernelTemplates.h"
+}
+
+const DspKernels* getAVX2Kernels()
+{
+	static const DspKernels kernels{ ApplyGain<Vector>, Saturate<Vector>, MeasurePeakAndEnergy<Vector> };
+	return &kernels;
+}
+#else
+const DspKernels* getAVX2Kernels()
+{
+	return nullptr;
+}
+#endif
\ No newline at end of file
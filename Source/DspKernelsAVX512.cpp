@@ -0,0 +1,56 @@
+#include "DspKernels.h"
+
+//Compiled with /arch:AVX512 (the "avx512" compiler flag scheme in
+//Plugin.jucer). Without that flag the variant is left out and never selected
+#if DSP_KERNELS_X86 && defined(__AVX512F__)
+#include <immintrin.h>
+
+//Fused multiply-adds round differently, so none are formed here either by
+//hand or by the compiler, which keeps the results equal to the SSE2 variant
+#ifdef _MSC_VER
+#pragma fp_contract(off)
+#endif
+
+namespace
+{
+	struct Vector
+	{
+		static const int width{ 16 };
+
+		__m512 value;
+
+		static Vector load(const float* data) { return { _mm512_loadu_ps(data) }; }
+		static Vector expand(float x) { return { _mm512_set1_ps(x) }; }
+		void store(float* data) const { _mm512_storeu_ps(data, value); }
+
+		static Vector lanes()
+		{
+			return { _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+				8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f) };
+		}
+
+		float sum() const { return _mm512_reduce_add_ps(value); }
+		float maximum() const { return _mm512_reduce_max_ps(value); }
+	};
+
+	inline Vector operator+(Vector a, Vector b) { return { _mm512_add_ps(a.value, b.value) }; }
+	inline Vector operator*(Vector a, Vector b) { return { _mm512_mul_ps(a.value, b.value) }; }
+	inline Vector operator/(Vector a, Vector b) { return { _mm512_div_ps(a.value, b.value) }; }
+	inline Vector Min(Vector a, Vector b) { return { _mm512_min_ps(a.value, b.value) }; }
+	inline Vector Max(Vector a, Vector b) { return { _mm512_max_ps(a.value, b.value) }; }
+	inline Vector Abs(Vector a) { return { _mm512_abs_ps(a.value) }; }
+
+#include "DspKernelTemplates.h"
+}
+
+const DspKernels* getAVX512Kernels()
+{
+	static const DspKernels kernels{ ApplyGain<Vector>, Saturate<Vector>, MeasurePeakAndEnergy<Vector> };
+	return &kernels;
+}
+#else
+const DspKernels* getAVX512Kernels()
+{
+	return nullptr;
+}
+#endif
\ No newline at end of file
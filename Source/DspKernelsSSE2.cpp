@@ -0,0 +1,75 @@
+#include "DspKernels.h"
+
+#if DSP_KERNELS_X86
+#include <emmintrin.h>
+#endif
+
+//The baseline every x64 processor has. Built with the project's default
+//code generation, so this file needs no special compiler flags
+namespace
+{
+#if DSP_KERNELS_X86
+	struct Vector
+	{
+		static const int width{ 4 };
+
+		__m128 value;
+
+		static Vector load(const float* data) { return { _mm_loadu_ps(data) }; }
+		static Vector expand(float x) { return { _mm_set1_ps(x) }; }
+		static Vector lanes() { return { _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f) }; }
+		void store(float* data) const { _mm_storeu_ps(data, value); }
+
+		float sum() const
+		{
+			const auto pairs = _mm_add_ps(value, _mm_movehl_ps(value, value));
+			return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+		}
+
+		float maximum() const
+		{
+			const auto pairs = _mm_max_ps(value, _mm_movehl_ps(value, value));
+			return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+		}
+	};
+
+	inline Vector operator+(Vector a, Vector b) { return { _mm_add_ps(a.value, b.value) }; }
+	inline Vector operator*(Vector a, Vector b) { return { _mm_mul_ps(a.value, b.value) }; }
+	inline Vector operator/(Vector a, Vector b) { return { _mm_div_ps(a.value, b.value) }; }
+	inline Vector Min(Vector a, Vector b) { return { _mm_min_ps(a.value, b.value) }; }
+	inline Vector Max(Vector a, Vector b) { return { _mm_max_ps(a.value, b.value) }; }
+	inline Vector Abs(Vector a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.value) }; }
+#else
+	//Elsewhere the kernels run one sample at a time and the compiler is
+	//left to vectorise them for whatever the target has
+	struct Vector
+	{
+		static const int width{ 1 };
+
+		float value;
+
+		static Vector load(const float* data) { return { *data }; }
+		static Vector expand(float x) { return { x }; }
+		static Vector lanes() { return { 0.0f }; }
+		void store(float* data) const { *data = value; }
+
+		float sum() const { return value; }
+		float maximum() const { return value; }
+	};
+
+	inline Vector operator+(Vector a, Vector b) { return { a.value + b.value }; }
+	inline Vector operator*(Vector a, Vector b) { return { a.value * b.value }; }
+	inline Vector operator/(Vector a, Vector b) { return { a.value / b.value }; }
+	inline Vector Min(Vector a, Vector b) { return { b.value < a.value ? b.value : a.value }; }
+	inline Vector Max(Vector a, Vector b) { return { a.value < b.value ? b.value : a.value }; }
+	inline Vector Abs(Vector a) { return { a.value < 0.0f ? -a.value : a.value }; }
+#endif
+
+#include "DspKernelTemplates.h"
+}
+
+const DspKernels* getSSE2Kernels()
+{
+	static const DspKernels kernels{ ApplyGain<Vector>, Saturate<Vector>, MeasurePeakAndEnergy<Vector> };
+	return &kernels;
+}
\ No newline at end of file
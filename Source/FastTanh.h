@@ -0,0 +1,38 @@
+#pragma once
+
+//The same Pade approximation as juce::dsp::FastMathApproximations::tanh,
+//shared by the DSP kernels and the ladder feedback loops. Vector only needs
+//expand, +, * and /. Always include this inside an anonymous namespace,
+//as the kernel variant files are built with different instruction sets
+//and must not end up sharing one copy through the linker
+template <typename Vector>
+Vector Tanh(Vector x)
+{
+	const auto x2 = x * x;
+	const auto numerator = x * (Vector::expand(135135.0f) + x2 * (Vector::expand(17325.0f) + x2 * (Vector::expand(378.0f) + x2)));
+	const auto denominator = Vector::expand(135135.0f) + x2 * (Vector::expand(62370.0f) + x2 * (Vector::expand(3150.0f) + Vector::expand(28.0f) * x2));
+	return numerator / denominator;
+}
+
+inline float TanhScalar(float x)
+{
+	const auto x2 = x * x;
+	const auto numerator = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+	const auto denominator = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2));
+	return numerator / denominator;
+}
+
+//tanh(x) / x, the slope of the line from the origin through the curve,
+//which a feedback loop can use as its gain. Past five the curve is held
+//at tanh(5) so the slope keeps falling instead of following the Pade
+//approximation back up. Also needs Min and Max
+template <typename Vector>
+Vector TanhSlope(Vector x)
+{
+	const auto limit = Vector::expand(5.0f);
+	const auto x2 = Min(x * x, limit * limit);
+	const auto numerator = Vector::expand(135135.0f) + x2 * (Vector::expand(17325.0f) + x2 * (Vector::expand(378.0f) + x2));
+	const auto denominator = Vector::expand(135135.0f) + x2 * (Vector::expand(62370.0f) + x2 * (Vector::expand(3150.0f) + Vector::expand(28.0f) * x2));
+	const auto magnitude = Max(x, Vector::expand(0.0f) - x);
+	return (numerator * limit) / (denominator * Max(magnitude, limit));
+}
\ No newline at end of file
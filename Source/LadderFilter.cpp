@@ -0,0 +1,307 @@
+#include "LadderFilter.h"
+
+namespace
+{
+	//How much of the feedback-summed input (a0) and of each of the four
+	//stage outputs is mixed into the output, per mode. Keeping these constexpr
+	//lets the compiler drop the unused terms from each kernel entirely
+	template <LadderFilter::Mode mode>
+	struct MixingCoefficients;
+
+	template <>
+	struct MixingCoefficients<LadderFilter::Mode::LPF12>
+	{
+		static constexpr float a0{ 0.0f }, a1{ 0.0f }, a2{ 1.0f }, a3{ 0.0f }, a4{ 0.0f };
+	};
+
+	template <>
+	struct MixingCoefficients<LadderFilter::Mode::HPF12>
+	{
+		static constexpr float a0{ 1.0f }, a1{ -2.0f }, a2{ 1.0f }, a3{ 0.0f }, a4{ 0.0f };
+	};
+
+	template <>
+	struct MixingCoefficients<LadderFilter::Mode::BPF12>
+	{
+		static constexpr float a0{ 0.0f }, a1{ 0.0f }, a2{ -1.0f }, a3{ 1.0f }, a4{ 0.0f };
+	};
+
+	template <>
+	struct MixingCoefficients<LadderFilter::Mode::LPF24>
+	{
+		static constexpr float a0{ 0.0f }, a1{ 0.0f }, a2{ 0.0f }, a3{ 0.0f }, a4{ 1.0f };
+	};
+
+	template <>
+	struct MixingCoefficients<LadderFilter::Mode::HPF24>
+	{
+		static constexpr float a0{ 1.0f }, a1{ -4.0f }, a2{ 6.0f }, a3{ -4.0f }, a4{ 1.0f };
+	};
+
+	template <>
+	struct MixingCoefficients<LadderFilter::Mode::BPF24>
+	{
+		static constexpr float a0{ 0.0f }, a1{ 0.0f }, a2{ 1.0f }, a3{ -2.0f }, a4{ 1.0f };
+	};
+
+	//The same values at runtime, for code that picks the mode per lane
+	template <LadderFilter::Mode mode>
+	void CopyMixingCoefficients(float* coefficients)
+	{
+		coefficients[0] = MixingCoefficients<mode>::a0;
+		coefficients[1] = MixingCoefficients<mode>::a1;
+		coefficients[2] = MixingCoefficients<mode>::a2;
+		coefficients[3] = MixingCoefficients<mode>::a3;
+		coefficients[4] = MixingCoefficients<mode>::a4;
+	}
+
+	//One float dressed up as a vector, so the channel loop can share the
+	//ladder solve with the multiband bank's four-lane version
+	struct Scalar
+	{
+		float value;
+
+		static Scalar expand(float x) { return { x }; }
+	};
+
+	inline Scalar operator+(Scalar a, Scalar b) { return { a.value + b.value }; }
+	inline Scalar operator-(Scalar a, Scalar b) { return { a.value - b.value }; }
+	inline Scalar operator*(Scalar a, Scalar b) { return { a.value * b.value }; }
+	inline Scalar operator/(Scalar a, Scalar b) { return { a.value / b.value }; }
+	inline Scalar Min(Scalar a, Scalar b) { return { juce::jmin(a.value, b.value) }; }
+	inline Scalar Max(Scalar a, Scalar b) { return { juce::jmax(a.value, b.value) }; }
+
+#include "LadderLoop.h"
+
+	//A loop gain of four puts the poles on the unit circle, where the ladder
+	//would ring forever. Stopping just short keeps every tail finite
+	const float maxFeedbackGain{ 3.92f };
+}
+
+LadderFilter::LadderFilter() : kernels(&DspKernels::get(InstructionSet::sse2))
+{
+	setCutoffFrequency(cutoffFrequency);
+	reset();
+}
+
+void LadderFilter::prepare(double sampleRate, int numChannels)
+{
+	jassert(numChannels <= maxChannels);
+
+	this->sampleRate = sampleRate;
+	this->numChannels = juce::jmin(numChannels, maxChannels);
+
+	//Recompute the integrator gain for the new sample rate
+	setCutoffFrequency(cutoffFrequency);
+	reset();
+}
+
+void LadderFilter::reset()
+{
+	for (auto& channelState : state)
+	{
+		channelState.stage[0] = 0.0f;
+		channelState.stage[1] = 0.0f;
+		channelState.stage[2] = 0.0f;
+		channelState.stage[3] = 0.0f;
+	}
+
+	//Jump straight to the targets so a fresh start does not ramp
+	currentG = targetG;
+	currentK = targetK;
+	currentDrive = targetDrive;
+	currentGain = targetGain;
+}
+
+void LadderFilter::setMode(Mode mode)
+{
+	this->mode = mode;
+}
+
+void LadderFilter::setDrive(float drive)
+{
+	targetDrive = drive;
+	targetGain = getDriveCompensation(drive);
+}
+
+void LadderFilter::setResonance(float resonance)
+{
+	targetK = getFeedbackGain(resonance);
+}
+
+void LadderFilter::setCutoffFrequency(float frequency)
+{
+	cutoffFrequency = frequency;
+	targetG = getIntegratorGain(frequency, sampleRate);
+}
+
+void LadderFilter::setKernels(const DspKernels& kernels)
+{
+	this->kernels = &kernels;
+}
+
+double LadderFilter::getPrewarpedGain(float frequency, double sampleRate)
+{
+	const auto nyquistLimit = static_cast<float>(sampleRate * 0.49);
+	return std::tan(juce::MathConstants<float>::pi
+		* juce::jlimit(1.0f, nyquistLimit, frequency) / static_cast<float>(sampleRate));
+}
+
+float LadderFilter::getIntegratorGain(float frequency, double sampleRate)
+{
+	//Integrator gain of each TPT one-pole, resolved as G = g / (1 + g)
+	const auto g = static_cast<float>(getPrewarpedGain(frequency, sampleRate));
+	return g / (1.0f + g);
+}
+
+float LadderFilter::getFeedbackGain(float resonance)
+{
+	return maxFeedbackGain * juce::jlimit(0.0f, 1.0f, resonance);
+}
+
+float LadderFilter::getDriveCompensation(float drive)
+{
+	//Loudness compensation for the input saturation (same curve as JUCE's ladder)
+	return std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+}
+
+double LadderFilter::getTailLength(float frequency, float resonance, float drive, double sampleRate, float threshold)
+{
+	//Near silence the tanh in the feedback is linear, so the ringing dies
+	//away at the rate of the linear ladder's slowest pole pair; louder
+	//ringing only decays faster. Relative to the cutoff the poles of
+	//(1 + s)^4 = -K lie at s = -1 + K^(1/4) e^(+-j pi/4), and they reach
+	//z through the same bilinear transform as the integrators
+	const auto g = getPrewarpedGain(frequency, sampleRate);
+	const auto root = std::pow(static_cast<double>(getFeedbackGain(resonance)), 0.25) / juce::MathConstants<double>::sqrt2;
+	const auto real = g * (root - 1.0);
+	const auto imaginary = g * root;
+
+	const auto squaredRadius = ((1.0 + real) * (1.0 + real) + imaginary * imaginary)
+		/ ((1.0 - real) * (1.0 - real) + imaginary * imaginary);
+	//A cutoff of a quarter of the sample rate puts the poles at zero
+	const auto decayPerSample = -0.5 * std::log(juce::jmax(squaredRadius, 1.0e-12));
+
+	//Nothing in the loop exceeds the compensated input, which the input
+	//saturation holds below its gain, plus the saturated feedback
+	const auto peak = static_cast<double>(getDriveCompensation(drive) + getFeedbackGain(resonance));
+	const auto decayAmount = std::log(peak / static_cast<double>(threshold));
+
+	//At low resonance the poles nearly coincide and build up before they
+	//decay, which can take up to about half as long again. A fast decay
+	//still has to pass through all four stages
+	return (2.0 * decayAmount / decayPerSample + 4.0) / sampleRate;
+}
+
+void LadderFilter::getMixingCoefficients(Mode mode, float* coefficients)
+{
+	switch (mode)
+	{
+	case Mode::LPF12: CopyMixingCoefficients<Mode::LPF12>(coefficients); break;
+	case Mode::HPF12: CopyMixingCoefficients<Mode::HPF12>(coefficients); break;
+	case Mode::BPF12: CopyMixingCoefficients<Mode::BPF12>(coefficients); break;
+	case Mode::LPF24: CopyMixingCoefficients<Mode::LPF24>(coefficients); break;
+	case Mode::HPF24: CopyMixingCoefficients<Mode::HPF24>(coefficients); break;
+	case Mode::BPF24: CopyMixingCoefficients<Mode::BPF24>(coefficients); break;
+	}
+}
+
+void LadderFilter::process(juce::dsp::AudioBlock<float>& block)
+{
+	const auto numSamples = static_cast<float>(block.getNumSamples());
+
+	if (numSamples == 0.0f)
+	{
+		return;
+	}
+
+	const Ramp g{ currentG, (targetG - currentG) / numSamples };
+	const Ramp k{ currentK, (targetK - currentK) / numSamples };
+	const Ramp drive{ currentDrive, (targetDrive - currentDrive) / numSamples };
+	const Ramp gain{ currentGain, (targetGain - currentGain) / numSamples };
+
+	//The saturation does not depend on the ladder's state, so it runs ahead
+	//of the feedback loop as one vectorised pass over each channel
+	const auto channels = juce::jmin(static_cast<int>(block.getNumChannels()), numChannels);
+
+	for (int channel = 0; channel < channels; ++channel)
+	{
+		kernels->saturate(block.getChannelPointer(static_cast<size_t>(channel)), static_cast<int>(block.getNumSamples()),
+			drive.start, drive.increment, gain.start, gain.increment);
+	}
+
+	//The mode is resolved once per block, never inside the sample loop
+	switch (mode)
+	{
+	case Mode::LPF12: processKernel<Mode::LPF12>(block, g, k); break;
+	case Mode::HPF12: processKernel<Mode::HPF12>(block, g, k); break;
+	case Mode::BPF12: processKernel<Mode::BPF12>(block, g, k); break;
+	case Mode::LPF24: processKernel<Mode::LPF24>(block, g, k); break;
+	case Mode::HPF24: processKernel<Mode::HPF24>(block, g, k); break;
+	case Mode::BPF24: processKernel<Mode::BPF24>(block, g, k); break;
+	}
+
+	currentG = targetG;
+	currentK = targetK;
+	currentDrive = targetDrive;
+	currentGain = targetGain;
+}
+
+float LadderFilter::getStateMagnitude() const
+{
+	auto magnitude = 0.0f;
+
+	for (int channel = 0; channel < numChannels; ++channel)
+	{
+		for (auto value : state[static_cast<size_t>(channel)].stage)
+		{
+			magnitude = juce::jmax(magnitude, std::abs(value));
+		}
+	}
+
+	return magnitude;
+}
+
+template <LadderFilter::Mode mode>
+void LadderFilter::processKernel(juce::dsp::AudioBlock<float>& block, const Ramp& g, const Ramp& k)
+{
+	constexpr auto a0 = MixingCoefficients<mode>::a0;
+	constexpr auto a1 = MixingCoefficients<mode>::a1;
+	constexpr auto a2 = MixingCoefficients<mode>::a2;
+	constexpr auto a3 = MixingCoefficients<mode>::a3;
+	constexpr auto a4 = MixingCoefficients<mode>::a4;
+
+	const auto channels = juce::jmin(static_cast<int>(block.getNumChannels()), numChannels);
+	const auto numSamples = static_cast<int>(block.getNumSamples());
+
+	for (int channel = 0; channel < channels; ++channel)
+	{
+		auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+		auto& stage = state[static_cast<size_t>(channel)].stage;
+
+		Scalar s0{ stage[0] };
+		Scalar s1{ stage[1] };
+		Scalar s2{ stage[2] };
+		Scalar s3{ stage[3] };
+
+		for (int sample = 0; sample < numSamples; sample++)
+		{
+			const auto step = static_cast<float>(sample);
+			const Scalar G{ g.start + g.increment * step };
+			const Scalar K{ k.start + k.increment * step };
+
+			//Already saturated by the kernel in process()
+			const Scalar x{ data[sample] };
+
+			const auto outputs = ProcessLadderSample(x, G, K, s0, s1, s2, s3);
+
+			data[sample] = a0 * outputs.u.value + a1 * outputs.y1.value + a2 * outputs.y2.value
+				+ a3 * outputs.y3.value + a4 * outputs.y4.value;
+		}
+
+		stage[0] = s0.value;
+		stage[1] = s1.value;
+		stage[2] = s2.value;
+		stage[3] = s3.value;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+//Zero-delay-feedback (TPT) Moog-style ladder built from four one-pole
+//stages, with the saturating feedback loop solved per sample instead of delayed
+class LadderFilter
+{
+public:
+
+	//Same ordering as juce::dsp::LadderFilterMode and the editor's mode box
+	enum class Mode
+	{
+		LPF12,
+		HPF12,
+		BPF12,
+		LPF24,
+		HPF24,
+		BPF24
+	};
+
+	static const int maxChannels{ 2 };
+
+	LadderFilter();
+
+	void prepare(double sampleRate, int numChannels);
+	void reset();
+
+	void setMode(Mode mode);
+	void setDrive(float drive);
+	void setResonance(float resonance);
+	void setCutoffFrequency(float frequency);
+
+	//The input saturation runs through these; set before processing starts
+	void setKernels(const DspKernels& kernels);
+
+	void process(juce::dsp::AudioBlock<float>& block);
+
+	//Largest stage value of any channel. Silent output does not mean a
+	//silent ladder, as high-pass modes can cancel out what the stages hold
+	float getStateMagnitude() const;
+
+	//The coefficient maths, shared with the multiband bank which runs
+	//several ladders side by side
+	static float getIntegratorGain(float frequency, double sampleRate);
+	static float getFeedbackGain(float resonance);
+	static float getDriveCompensation(float drive);
+	static void getMixingCoefficients(Mode mode, float* coefficients);
+
+	//How long the ladder can take to ring down to the threshold once its
+	//input stops, from the decay of the saturated feedback loop
+	static double getTailLength(float frequency, float resonance, float drive, double sampleRate, float threshold);
+
+private:
+
+	//The bilinear transform's prewarped gain for the cutoff, g = tan(pi * f / fs)
+	static double getPrewarpedGain(float frequency, double sampleRate);
+
+	//Each parameter moves linearly from its current to its target value
+	//across one processed block so that changes do not click
+	struct Ramp
+	{
+		float start;
+		float increment;
+	};
+
+	//The four stage integrators of one channel fit a single SIMD register
+	struct alignas(16) ChannelState
+	{
+		float stage[4];
+	};
+
+	template <Mode mode>
+	void processKernel(juce::dsp::AudioBlock<float>& block, const Ramp& g, const Ramp& k);
+
+	Mode mode{ Mode::LPF24 };
+
+	int numChannels{ 0 };
+	double sampleRate{ 44100.0 };
+
+	float targetG{ 0.0f };
+	float targetK{ 0.0f };
+	float targetDrive{ 1.0f };
+	float targetGain{ 1.0f };
+
+	float currentG{ 0.0f };
+	float currentK{ 0.0f };
+	float currentDrive{ 1.0f };
+	float currentGain{ 1.0f };
+
+	float cutoffFrequency{ 200.0f };
+
+	const DspKernels* kernels;
+
+	std::array<ChannelState, maxChannels> state;
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "FastTanh.h"
+
+//One sample of the four-stage ladder around its saturating feedback loop,
+//shared by LadderFilter and the multiband bank so the two cannot drift
+//apart. Vector needs expand, +, -, *, / and Min and Max. Include this
+//inside an anonymous namespace, for the same reason as FastTanh.h
+
+//The feedback-summed input (u) and the four stage outputs
+template <typename Vector>
+struct LadderOutputs
+{
+	Vector u, y1, y2, y3, y4;
+};
+
+//x is the (already saturated) input, G the resolved integrator gain and K
+//the feedback gain. The stage states s0 to s3 are advanced in place
+template <typename Vector>
+LadderOutputs<Vector> ProcessLadderSample(Vector x, Vector G, Vector K, Vector& s0, Vector& s1, Vector& s2, Vector& s3)
+{
+	const auto one = Vector::expand(1.0f);
+	const auto beta = one - G;
+
+	//Each stage is y = G * input + beta * s, so the last stage output is
+	//G^4 * u plus the stored states, letting us solve the feedback exactly
+	const auto G2 = G * G;
+	const auto G4 = G2 * G2;
+	const auto sigma = beta * (G2 * G * s0 + G2 * s1 + G * s2 + s3);
+
+	//The feedback is K * tanh(y4), so loud ringing lowers its own loop gain.
+	//Replacing tanh by its slope through the linear solution for y4 keeps
+	//the solve closed-form, and is exact for small signals
+	const auto estimate = G4 * ((x - K * sigma) / (one + K * G4)) + sigma;
+	const auto feedback = K * TanhSlope(estimate);
+	const auto u = (x - feedback * sigma) / (one + feedback * G4);
+
+	auto v = (u - s0) * G;
+	const auto y1 = v + s0;
+	s0 = y1 + v;
+
+	v = (y1 - s1) * G;
+	const auto y2 = v + s1;
+	s1 = y2 + v;
+
+	v = (y2 - s2) * G;
+	const auto y3 = v + s2;
+	s2 = y3 + v;
+
+	v = (y3 - s3) * G;
+	const auto y4 = v + s3;
+	s3 = y4 + v;
+
+	return { u, y1, y2, y3, y4 };
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "LevelMeter.h"
+
+#if JUCE_USE_SIMD
+using FloatRegister = juce::dsp::SIMDRegister<float>;
+#endif
+
+LevelMeter::LevelMeter() : kernels(&DspKernels::get(InstructionSet::sse2))
+{
+	//Windowed-sinc interpolator for 4x oversampling, the same length as
+	//the filter suggested for true-peak meters in ITU-R BS.1770
+	const auto numTaps = tapsPerPhase * oversampling;
+	const auto centre = (numTaps - 1) * 0.5;
+
+	for (int phase = 0; phase < oversampling; ++phase)
+	{
+		auto phaseSum = 0.0;
+
+		for (int tap = 0; tap < tapsPerPhase; ++tap)
+		{
+			const auto index = tap * oversampling + phase;
+			const auto time = (index - centre) / oversampling;
+			const auto sinc = time == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * time) / (juce::MathConstants<double>::pi * time);
+			const auto window = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * (index + 0.5) / numTaps)
+				+ 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * (index + 0.5) / numTaps);
+
+			coefficients[tap][phase] = static_cast<float>(sinc * window);
+			phaseSum += sinc * window;
+		}
+
+		//Every phase passes DC at unity gain
+		for (int tap = 0; tap < tapsPerPhase; ++tap)
+		{
+			coefficients[tap][phase] = static_cast<float>(coefficients[tap][phase] / phaseSum);
+		}
+	}
+
+	for (int channel = 0; channel < maxChannels; ++channel)
+	{
+		peakLevels[static_cast<size_t>(channel)] = 0.0f;
+		rmsLevels[static_cast<size_t>(channel)] = 0.0f;
+		truePeakLevels[static_cast<size_t>(channel)] = 0.0f;
+	}
+}
+
+void LevelMeter::prepare(double sampleRate, int numChannels)
+{
+	this->sampleRate = sampleRate;
+	this->numChannels = juce::jmin(numChannels, maxChannels);
+
+	for (auto& channel : channels)
+	{
+		channel.blocks.resize(maxWindowBlocks);
+	}
+
+	reset();
+}
+
+void LevelMeter::reset()
+{
+	for (int i = 0; i < maxChannels; ++i)
+	{
+		auto& channel = channels[static_cast<size_t>(i)];
+
+		std::fill(std::begin(channel.history), std::end(channel.history), 0.0f);
+		channel.historyPosition = 0;
+		channel.oldestBlock = 0;
+		channel.numBlocks = 0;
+		channel.windowSumOfSquares = 0.0;
+		channel.windowNumSamples = 0;
+		channel.peak = 0.0f;
+		channel.truePeak = 0.0f;
+
+		peakLevels[static_cast<size_t>(i)] = 0.0f;
+		rmsLevels[static_cast<size_t>(i)] = 0.0f;
+		truePeakLevels[static_cast<size_t>(i)] = 0.0f;
+	}
+}
+
+void LevelMeter::setRmsWindow(double seconds)
+{
+	rmsWindowSeconds = static_cast<float>(seconds);
+}
+
+void LevelMeter::setKernels(const DspKernels& kernels)
+{
+	this->kernels = &kernels;
+}
+
+float LevelMeter::getPeak(int channel) const
+{
+	return peakLevels[static_cast<size_t>(channel)].load(std::memory_order_relaxed);
+}
+
+float LevelMeter::getRms(int channel) const
+{
+	return rmsLevels[static_cast<size_t>(channel)].load(std::memory_order_relaxed);
+}
+
+float LevelMeter::getTruePeak(int channel) const
+{
+	return truePeakLevels[static_cast<size_t>(channel)].load(std::memory_order_relaxed);
+}
+
+void LevelMeter::process(const juce::AudioBuffer<float>& buffer)
+{
+	const auto numSamples = buffer.getNumSamples();
+
+	if (numSamples == 0)
+	{
+		return;
+	}
+
+	const auto windowLength = juce::jmax(1, static_cast<int>(rmsWindowSeconds.load() * sampleRate));
+	const auto release = std::pow(10.0f, -peakReleaseDecibelsPerSecond * numSamples / (20.0f * static_cast<float>(sampleRate)));
+
+	for (int i = 0; i < juce::jmin(numChannels, buffer.getNumChannels()); ++i)
+	{
+		auto& channel = channels[static_cast<size_t>(i)];
+		const auto* data = buffer.getReadPointer(i);
+
+		auto blockPeak = 0.0f;
+		auto sumOfSquares = 0.0;
+
+		measurePeakAndEnergy(data, numSamples, blockPeak, sumOfSquares);
+		updateRmsWindow(channel, sumOfSquares, numSamples, windowLength);
+
+		//Interpolation ripple can put the true peak a hair under the
+		//sample peak, which a meter should never show
+		const auto blockTruePeak = juce::jmax(blockPeak, measureTruePeak(channel, data, numSamples));
+
+		channel.peak = juce::jmax(blockPeak, channel.peak * release);
+		channel.truePeak = juce::jmax(blockTruePeak, channel.truePeak * release);
+
+		const auto meanSquare = channel.windowSumOfSquares / juce::jmax(1, channel.windowNumSamples);
+
+		peakLevels[static_cast<size_t>(i)].store(channel.peak, std::memory_order_relaxed);
+		rmsLevels[static_cast<size_t>(i)].store(static_cast<float>(std::sqrt(meanSquare)), std::memory_order_relaxed);
+		truePeakLevels[static_cast<size_t>(i)].store(channel.truePeak, std::memory_order_relaxed);
+	}
+}
+
+void LevelMeter::measurePeakAndEnergy(const float* data, int numSamples, float& peak, double& sumOfSquares) const
+{
+	auto squares = 0.0f;
+	kernels->measurePeakAndEnergy(data, numSamples, &peak, &squares);
+	sumOfSquares = static_cast<double>(squares);
+}
+
+float LevelMeter::measureTruePeak(ChannelState& channel, const float* data, int numSamples) const
+{
+	auto position = channel.historyPosition;
+
+#if JUCE_USE_SIMD
+	static_assert(FloatRegister::SIMDNumElements == oversampling, "One lane per oversampled phase");
+
+	auto maximumRegister = FloatRegister::expand(0.0f);
+
+	for (int sample = 0; sample < numSamples; ++sample)
+	{
+		position = (position == 0 ? tapsPerPhase : position) - 1;
+		channel.history[position] = data[sample];
+		channel.history[position + tapsPerPhase] = data[sample];
+
+		//All four interpolated points between this sample and the last
+		//one, computed together
+		auto interpolated = FloatRegister::expand(0.0f);
+
+		for (int tap = 0; tap < tapsPerPhase; ++tap)
+		{
+			interpolated = FloatRegister::multiplyAdd(interpolated,
+				FloatRegister::fromRawArray(coefficients[tap]),
+				FloatRegister::expand(channel.history[position + tap]));
+		}
+
+		maximumRegister = FloatRegister::max(maximumRegister, FloatRegister::abs(interpolated));
+	}
+
+	auto maximum = 0.0f;
+
+	for (size_t lane = 0; lane < FloatRegister::SIMDNumElements; ++lane)
+	{
+		maximum = juce::jmax(maximum, maximumRegister.get(lane));
+	}
+#else
+	auto maximum = 0.0f;
+
+	for (int sample = 0; sample < numSamples; ++sample)
+	{
+		position = (position == 0 ? tapsPerPhase : position) - 1;
+		channel.history[position] = data[sample];
+		channel.history[position + tapsPerPhase] = data[sample];
+
+		for (int phase = 0; phase < oversampling; ++phase)
+		{
+			auto interpolated = 0.0f;
+
+			for (int tap = 0; tap < tapsPerPhase; ++tap)
+			{
+				interpolated += coefficients[tap][phase] * channel.history[position + tap];
+			}
+
+			maximum = juce::jmax(maximum, std::abs(interpolated));
+		}
+	}
+#endif
+
+	channel.historyPosition = position;
+	return maximum;
+}
+
+void LevelMeter::updateRmsWindow(ChannelState& channel, double sumOfSquares, int numSamples, int windowLength)
+{
+	auto DropOldestBlock = [&channel]
+	{
+		const auto& oldest = channel.blocks[static_cast<size_t>(channel.oldestBlock)];
+		channel.windowSumOfSquares -= oldest.sumOfSquares;
+		channel.windowNumSamples -= oldest.numSamples;
+		channel.oldestBlock = (channel.oldestBlock + 1) % maxWindowBlocks;
+		channel.numBlocks--;
+	};
+
+	if (channel.numBlocks == maxWindowBlocks)
+	{
+		DropOldestBlock();
+	}
+
+	const auto newest = (channel.oldestBlock + channel.numBlocks) % maxWindowBlocks;
+	channel.blocks[static_cast<size_t>(newest)] = { sumOfSquares, numSamples };
+	channel.windowSumOfSquares += sumOfSquares;
+	channel.windowNumSamples += numSamples;
+	channel.numBlocks++;
+
+	//Keep the newest block even if it alone is longer than the window
+	while (channel.numBlocks > 1
+		&& channel.windowNumSamples - channel.blocks[static_cast<size_t>(channel.oldestBlock)].numSamples >= windowLength)
+	{
+		DropOldestBlock();
+	}
+
+	//Adding and removing block energies leaves rounding residue behind
+	channel.windowSumOfSquares = juce::jmax(0.0, channel.windowSumOfSquares);
+}
\ No newline at end of file
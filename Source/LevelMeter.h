@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+//Per-channel sample peak, windowed RMS and 4x oversampled true-peak of
+//whatever buffer is passed to process(). The readings are published as
+//atomics so the editor, or anything else, can poll them from any thread
+class LevelMeter
+{
+public:
+
+	static const int maxChannels{ 2 };
+
+	LevelMeter();
+
+	void prepare(double sampleRate, int numChannels);
+	void reset();
+
+	//The RMS reading averages over roughly this many seconds, rounded to
+	//whole blocks. Can be called from any thread
+	void setRmsWindow(double seconds);
+
+	//The sample peak and energy are measured through these
+	void setKernels(const DspKernels& kernels);
+
+	void process(const juce::AudioBuffer<float>& buffer);
+
+	float getPeak(int channel) const;
+	float getRms(int channel) const;
+	float getTruePeak(int channel) const;
+
+private:
+
+	//Each oversampled phase fills one lane of a 4-wide SIMD register
+	static const int oversampling{ 4 };
+	static const int tapsPerPhase{ 12 };
+	static const int maxWindowBlocks{ 4096 };
+
+	//Energy of one processed block, kept so that the RMS window can drop
+	//whole blocks as they fall out of it
+	struct BlockEnergy
+	{
+		double sumOfSquares;
+		int numSamples;
+	};
+
+	struct ChannelState
+	{
+		//The last few input samples, stored twice over so that the
+		//interpolator can always read them as one contiguous run
+		alignas(16) float history[2 * tapsPerPhase];
+		int historyPosition;
+
+		std::vector<BlockEnergy> blocks;
+		int oldestBlock;
+		int numBlocks;
+		double windowSumOfSquares;
+		int windowNumSamples;
+
+		float peak;
+		float truePeak;
+	};
+
+	void measurePeakAndEnergy(const float* data, int numSamples, float& peak, double& sumOfSquares) const;
+	float measureTruePeak(ChannelState& channel, const float* data, int numSamples) const;
+	void updateRmsWindow(ChannelState& channel, double sumOfSquares, int numSamples, int windowLength);
+
+	//Displayed peaks fall back at this rate once the signal drops
+	const float peakReleaseDecibelsPerSecond{ 20.0f };
+
+	int numChannels{ 0 };
+	double sampleRate{ 44100.0 };
+	std::atomic<float> rmsWindowSeconds{ 0.3f };
+	const DspKernels* kernels;
+
+	//Polyphase taps of the interpolator, tap-major so that each row holds
+	//the same tap of all four phases
+	alignas(16) float coefficients[tapsPerPhase][oversampling];
+
+	std::array<ChannelState, maxChannels> channels;
+
+	std::array<std::atomic<float>, maxChannels> peakLevels;
+	std::array<std::atomic<float>, maxChannels> rmsLevels;
+	std::array<std::atomic<float>, maxChannels> truePeakLevels;
+};
\ No newline at end of file
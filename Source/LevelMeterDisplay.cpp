@@ -0,0 +1,84 @@
+#include "LevelMeterDisplay.h"
+
+LevelMeterDisplay::LevelMeterDisplay(const LevelMeter& levelMeter) : levelMeter(levelMeter)
+{
+	peaks.fill(0.0f);
+	rmsLevels.fill(0.0f);
+
+	setInterceptsMouseClicks(false, false);
+	startTimerHz(refreshRate);
+}
+
+LevelMeterDisplay::~LevelMeterDisplay()
+{
+	stopTimer();
+}
+
+void LevelMeterDisplay::timerCallback()
+{
+	auto hasChanged = false;
+	auto newTruePeak = 0.0f;
+
+	for (int channel = 0; channel < LevelMeter::maxChannels; ++channel)
+	{
+		const auto peak = levelMeter.getPeak(channel);
+		const auto rms = levelMeter.getRms(channel);
+
+		hasChanged = hasChanged || peak != peaks[static_cast<size_t>(channel)] || rms != rmsLevels[static_cast<size_t>(channel)];
+
+		peaks[static_cast<size_t>(channel)] = peak;
+		rmsLevels[static_cast<size_t>(channel)] = rms;
+		newTruePeak = juce::jmax(newTruePeak, levelMeter.getTruePeak(channel));
+	}
+
+	if (hasChanged || newTruePeak != truePeak)
+	{
+		truePeak = newTruePeak;
+		repaint();
+	}
+}
+
+void LevelMeterDisplay::paint(juce::Graphics& graphics)
+{
+	auto bounds = getLocalBounds().toFloat();
+	auto textBounds = bounds.removeFromTop(static_cast<float>(textHeight));
+
+	//Anything over 0 dBTP will clip somewhere down the line
+	const auto truePeakDecibels = juce::Decibels::gainToDecibels(truePeak, minDecibels);
+
+	graphics.setColour(truePeakDecibels > 0.0f ? juce::Colours::red
+		: juce::Colour::fromFloatRGBA(0.75f, 0.75f, 0.75f, 1.0f));
+	graphics.setFont(12.0f);
+	graphics.drawText(truePeakDecibels <= minDecibels ? juce::String("-inf")
+		: juce::String(truePeakDecibels, 1) + " TP", textBounds, juce::Justification::centred);
+
+	auto ToHeight = [this, &bounds](float gain)
+	{
+		auto decibels = juce::Decibels::gainToDecibels(gain, minDecibels);
+		return juce::jmap(juce::jlimit(minDecibels, maxDecibels, decibels), minDecibels, maxDecibels, 0.0f, bounds.getHeight());
+	};
+
+	const auto barWidth = bounds.getWidth() / LevelMeter::maxChannels;
+	const auto zeroHeight = ToHeight(1.0f);
+
+	for (int channel = 0; channel < LevelMeter::maxChannels; ++channel)
+	{
+		auto bar = bounds.withX(bounds.getX() + barWidth * channel).withWidth(barWidth).reduced(2.0f, 0.0f);
+
+		graphics.setColour(juce::Colour(23, 24, 23).brighter(0.1f));
+		graphics.fillRect(bar);
+
+		//RMS as the filled bar, peak as a line above it
+		const auto rmsHeight = ToHeight(rmsLevels[static_cast<size_t>(channel)]);
+		graphics.setColour(juce::Colour::fromFloatRGBA(0.15f, 0.5f, 0.8f, 1.0f));
+		graphics.fillRect(bar.withTop(bar.getBottom() - rmsHeight));
+
+		const auto peakHeight = ToHeight(peaks[static_cast<size_t>(channel)]);
+		graphics.setColour(peakHeight > zeroHeight ? juce::Colours::red : juce::Colours::white);
+		graphics.fillRect(bar.withTop(bar.getBottom() - peakHeight).withHeight(2.0f));
+	}
+
+	//0 dBFS mark
+	graphics.setColour(juce::Colour::fromFloatRGBA(0.75f, 0.75f, 0.75f, 0.5f));
+	graphics.drawHorizontalLine(static_cast<int>(bounds.getBottom() - zeroHeight), bounds.getX(), bounds.getRight());
+}
\ No newline at end of file
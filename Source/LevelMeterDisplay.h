@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <JuceHeader.h>
+#include "LevelMeter.h"
+
+//Vertical peak/RMS bars for each channel with the highest true-peak
+//reading printed above them, polled from a LevelMeter on the message thread
+class LevelMeterDisplay : public juce::Component, private juce::Timer
+{
+public:
+
+	LevelMeterDisplay(const LevelMeter& levelMeter);
+	~LevelMeterDisplay() override;
+
+	void paint(juce::Graphics& graphics) override;
+
+private:
+
+	void timerCallback() override;
+
+	const float minDecibels{ -60.0f };
+	const float maxDecibels{ 6.0f };
+	const int refreshRate{ 30 };
+	const int textHeight{ 14 };
+
+	const LevelMeter& levelMeter;
+
+	std::array<float, LevelMeter::maxChannels> peaks;
+	std::array<float, LevelMeter::maxChannels> rmsLevels;
+	float truePeak{ 0.0f };
+};
\ No newline at end of file
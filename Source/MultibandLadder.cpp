@@ -0,0 +1,374 @@
+#include "MultibandLadder.h"
+
+#if JUCE_USE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	//Four floats, one per band, with just the arithmetic the ladder needs.
+	//Without SSE the plain loops are left to the compiler to vectorise
+#if JUCE_USE_SSE_INTRINSICS
+	struct Vector
+	{
+		__m128 value;
+
+		static Vector load(const float* data) { return { _mm_load_ps(data) }; }
+		static Vector expand(float x) { return { _mm_set1_ps(x) }; }
+		void store(float* data) const { _mm_store_ps(data, value); }
+
+		float sum() const
+		{
+			const auto pairs = _mm_add_ps(value, _mm_movehl_ps(value, value));
+			return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+		}
+	};
+
+	inline Vector operator+(Vector a, Vector b) { return { _mm_add_ps(a.value, b.value) }; }
+	inline Vector operator-(Vector a, Vector b) { return { _mm_sub_ps(a.value, b.value) }; }
+	inline Vector operator*(Vector a, Vector b) { return { _mm_mul_ps(a.value, b.value) }; }
+	inline Vector operator/(Vector a, Vector b) { return { _mm_div_ps(a.value, b.value) }; }
+	inline Vector Min(Vector a, Vector b) { return { _mm_min_ps(a.value, b.value) }; }
+	inline Vector Max(Vector a, Vector b) { return { _mm_max_ps(a.value, b.value) }; }
+#else
+	struct Vector
+	{
+		float value[4];
+
+		static Vector load(const float* data) { return { { data[0], data[1], data[2], data[3] } }; }
+		static Vector expand(float x) { return { { x, x, x, x } }; }
+		void store(float* data) const { std::copy(std::begin(value), std::end(value), data); }
+
+		float sum() const { return (value[0] + value[1]) + (value[2] + value[3]); }
+	};
+
+	template <typename Operation>
+	inline Vector Apply(Vector a, Vector b, Operation operation)
+	{
+		Vector result;
+
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			result.value[lane] = operation(a.value[lane], b.value[lane]);
+		}
+
+		return result;
+	}
+
+	inline Vector operator+(Vector a, Vector b) { return Apply(a, b, [](float x, float y) { return x + y; }); }
+	inline Vector operator-(Vector a, Vector b) { return Apply(a, b, [](float x, float y) { return x - y; }); }
+	inline Vector operator*(Vector a, Vector b) { return Apply(a, b, [](float x, float y) { return x * y; }); }
+	inline Vector operator/(Vector a, Vector b) { return Apply(a, b, [](float x, float y) { return x / y; }); }
+	inline Vector Min(Vector a, Vector b) { return Apply(a, b, [](float x, float y) { return juce::jmin(x, y); }); }
+	inline Vector Max(Vector a, Vector b) { return Apply(a, b, [](float x, float y) { return juce::jmax(x, y); }); }
+#endif
+
+#include "FastTanh.h"
+#include "LadderLoop.h"
+}
+
+MultibandLadder::MultibandLadder()
+{
+	crossoverFrequencies = { { 200.0f, 2000.0f, 8000.0f } };
+	cutoffFrequencies.fill(24000.0f);
+
+	for (int band = 0; band < maxBands; ++band)
+	{
+		setMode(band, LadderFilter::Mode::LPF24);
+		setDrive(band, 1.0f);
+		setResonance(band, 0.0f);
+		setCutoffFrequency(band, cutoffFrequencies[static_cast<size_t>(band)]);
+	}
+
+	for (auto& bandAllpasses : allpasses)
+	{
+		for (auto& allpass : bandAllpasses)
+		{
+			allpass.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+		}
+	}
+
+	reset();
+}
+
+void MultibandLadder::prepare(double sampleRate, int numChannels)
+{
+	jassert(numChannels <= maxChannels);
+
+	this->sampleRate = sampleRate;
+	this->numChannels = juce::jmin(numChannels, maxChannels);
+
+	//The crossovers only keep per-channel state, so the block size is irrelevant
+	const juce::dsp::ProcessSpec spec{ sampleRate, 512, static_cast<juce::uint32>(juce::jmax(1, this->numChannels)) };
+
+	for (auto& crossover : crossovers)
+	{
+		crossover.prepare(spec);
+	}
+
+	for (auto& bandAllpasses : allpasses)
+	{
+		for (auto& allpass : bandAllpasses)
+		{
+			allpass.prepare(spec);
+		}
+	}
+
+	//Recompute the integrator gains for the new sample rate
+	for (int band = 0; band < maxBands; ++band)
+	{
+		setCutoffFrequency(band, cutoffFrequencies[static_cast<size_t>(band)]);
+	}
+
+	haveCrossoversChanged = true;
+	reset();
+}
+
+void MultibandLadder::reset()
+{
+	for (auto& channelState : state)
+	{
+		for (auto& stage : channelState.stage)
+		{
+			std::fill(std::begin(stage.band), std::end(stage.band), 0.0f);
+		}
+	}
+
+	for (auto& crossover : crossovers)
+	{
+		crossover.reset();
+	}
+
+	for (auto& bandAllpasses : allpasses)
+	{
+		for (auto& allpass : bandAllpasses)
+		{
+			allpass.reset();
+		}
+	}
+
+	//Jump straight to the targets so a fresh start does not ramp
+	currentG = targetG;
+	currentK = targetK;
+	currentDrive = targetDrive;
+	currentGain = targetGain;
+}
+
+void MultibandLadder::setNumBands(int numBands)
+{
+	numBands = juce::jlimit(1, maxBands, numBands);
+
+	//The bands no longer cover the same ranges, so their ringing is meaningless
+	if (numBands != this->numBands)
+	{
+		this->numBands = numBands;
+		reset();
+	}
+}
+
+int MultibandLadder::getNumBands() const
+{
+	return numBands;
+}
+
+void MultibandLadder::setCrossoverFrequency(int index, float frequency)
+{
+	jassert(index >= 0 && index < maxBands - 1);
+
+	if (crossoverFrequencies[static_cast<size_t>(index)] != frequency)
+	{
+		crossoverFrequencies[static_cast<size_t>(index)] = frequency;
+		haveCrossoversChanged = true;
+	}
+}
+
+void MultibandLadder::setMode(int band, LadderFilter::Mode mode)
+{
+	float coefficients[5];
+	LadderFilter::getMixingCoefficients(mode, coefficients);
+
+	for (size_t i = 0; i < mixing.size(); ++i)
+	{
+		mixing[i].band[band] = coefficients[i];
+	}
+}
+
+void MultibandLadder::setDrive(int band, float drive)
+{
+	targetDrive.band[band] = drive;
+	targetGain.band[band] = LadderFilter::getDriveCompensation(drive);
+}
+
+void MultibandLadder::setResonance(int band, float resonance)
+{
+	targetK.band[band] = LadderFilter::getFeedbackGain(resonance);
+}
+
+void MultibandLadder::setCutoffFrequency(int band, float frequency)
+{
+	cutoffFrequencies[static_cast<size_t>(band)] = frequency;
+	targetG.band[band] = LadderFilter::getIntegratorGain(frequency, sampleRate);
+}
+
+void MultibandLadder::updateCrossovers()
+{
+	auto previousFrequency = 20.0f;
+	const auto maxFrequency = static_cast<float>(sampleRate * 0.45);
+
+	for (size_t i = 0; i < crossovers.size(); ++i)
+	{
+		const auto frequency = juce::jlimit(previousFrequency, juce::jmax(previousFrequency, maxFrequency), crossoverFrequencies[i]);
+
+		crossovers[i].setCutoffFrequency(frequency);
+
+		for (auto& bandAllpasses : allpasses)
+		{
+			bandAllpasses[i].setCutoffFrequency(frequency);
+		}
+
+		previousFrequency = frequency;
+	}
+
+	haveCrossoversChanged = false;
+}
+
+void MultibandLadder::process(juce::dsp::AudioBlock<float>& block)
+{
+	const auto numSamples = static_cast<int>(block.getNumSamples());
+
+	if (numSamples == 0)
+	{
+		return;
+	}
+
+	if (haveCrossoversChanged)
+	{
+		updateCrossovers();
+	}
+
+	const auto inverseLength = Vector::expand(1.0f / static_cast<float>(numSamples));
+
+	auto Start = [](const Lanes& current) { return Vector::load(current.band); };
+	auto Increment = [&inverseLength](const Lanes& current, const Lanes& target)
+	{
+		return (Vector::load(target.band) - Vector::load(current.band)) * inverseLength;
+	};
+
+	//Each parameter moves linearly to its target across the block, as in LadderFilter
+	const auto gStart = Start(currentG);
+	const auto kStart = Start(currentK);
+	const auto driveStart = Start(currentDrive);
+	const auto gainStart = Start(currentGain);
+
+	const auto gIncrement = Increment(currentG, targetG);
+	const auto kIncrement = Increment(currentK, targetK);
+	const auto driveIncrement = Increment(currentDrive, targetDrive);
+	const auto gainIncrement = Increment(currentGain, targetGain);
+
+	const auto a0 = Vector::load(mixing[0].band);
+	const auto a1 = Vector::load(mixing[1].band);
+	const auto a2 = Vector::load(mixing[2].band);
+	const auto a3 = Vector::load(mixing[3].band);
+	const auto a4 = Vector::load(mixing[4].band);
+
+	const auto limit = Vector::expand(5.0f);
+	const auto negativeLimit = Vector::expand(-5.0f);
+
+	const auto channels = juce::jmin(static_cast<int>(block.getNumChannels()), numChannels);
+
+	for (int channel = 0; channel < channels; ++channel)
+	{
+		auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+		auto& stage = state[static_cast<size_t>(channel)].stage;
+
+		auto s0 = Vector::load(stage[0].band);
+		auto s1 = Vector::load(stage[1].band);
+		auto s2 = Vector::load(stage[2].band);
+		auto s3 = Vector::load(stage[3].band);
+
+		Lanes input{};
+
+		for (int sample = 0; sample < numSamples; sample++)
+		{
+			//Split off one band per crossover, lowest first
+			auto rest = data[sample];
+
+			for (int i = 0; i < numBands - 1; ++i)
+			{
+				crossovers[static_cast<size_t>(i)].processSample(channel, rest, input.band[i], rest);
+			}
+
+			input.band[numBands - 1] = rest;
+
+			//Give each lower band the phase shift the higher splits put on the others
+			for (int band = 0; band < numBands - 2; ++band)
+			{
+				for (int i = band + 1; i < numBands - 1; ++i)
+				{
+					input.band[band] = allpasses[static_cast<size_t>(band)][static_cast<size_t>(i)].processSample(channel, input.band[band]);
+				}
+			}
+
+			//From here on all four band ladders advance together
+			const auto step = Vector::expand(static_cast<float>(sample));
+			const auto G = gStart + gIncrement * step;
+			const auto K = kStart + kIncrement * step;
+			const auto drive = driveStart + driveIncrement * step;
+			const auto gain = gainStart + gainIncrement * step;
+
+			const auto x = gain * Tanh(Min(limit, Max(negativeLimit, drive * Vector::load(input.band))));
+			const auto outputs = ProcessLadderSample(x, G, K, s0, s1, s2, s3);
+
+			//Bands that are not in use hold silence, so summing every lane is safe
+			data[sample] = (a0 * outputs.u + a1 * outputs.y1 + a2 * outputs.y2 + a3 * outputs.y3 + a4 * outputs.y4).sum();
+		}
+
+		s0.store(stage[0].band);
+		s1.store(stage[1].band);
+		s2.store(stage[2].band);
+		s3.store(stage[3].band);
+	}
+
+	currentG = targetG;
+	currentK = targetK;
+	currentDrive = targetDrive;
+	currentGain = targetGain;
+}
+
+float MultibandLadder::getStateMagnitude() const
+{
+	auto magnitude = 0.0f;
+
+	for (int channel = 0; channel < numChannels; ++channel)
+	{
+		for (const auto& stage : state[static_cast<size_t>(channel)].stage)
+		{
+			for (int band = 0; band < numBands; ++band)
+			{
+				magnitude = juce::jmax(magnitude, std::abs(stage.band[band]));
+			}
+		}
+	}
+
+	return magnitude;
+}
+
+double MultibandLadder::getCrossoverTailLength(float threshold) const
+{
+	//Every band passes each crossover in use once, as the split itself or
+	//as the matching allpass, and filters in series ring for the sum of
+	//their tails. A Linkwitz-Riley section's poles decay at 2 pi f / sqrt(2),
+	//and they come in pairs, so the time is doubled as in LadderFilter
+	const auto decayAmount = -std::log(static_cast<double>(threshold));
+	auto tailLength = 0.0;
+
+	for (int i = 0; i < numBands - 1; ++i)
+	{
+		const auto frequency = juce::jmax(20.0, static_cast<double>(crossoverFrequencies[static_cast<size_t>(i)]));
+		const auto decayRate = juce::MathConstants<double>::twoPi * frequency / juce::MathConstants<double>::sqrt2;
+
+		tailLength += 2.0 * decayAmount / decayRate;
+	}
+
+	return tailLength;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <JuceHeader.h>
+#include "LadderFilter.h"
+
+//Splits the input into two to four bands with a Linkwitz-Riley crossover
+//tree and runs a separate ladder on each band before summing them again.
+//Lower bands pass through allpasses matching the crossovers above them,
+//so with transparent ladders the bands add back up to a flat response.
+//
+//The band ladders run side by side in the four lanes of one SIMD
+//register, so four bands cost about as much as one ladder does on its own
+class MultibandLadder
+{
+public:
+
+	static const int maxBands{ 4 };
+	static const int maxChannels{ LadderFilter::maxChannels };
+
+	MultibandLadder();
+
+	void prepare(double sampleRate, int numChannels);
+	void reset();
+
+	void setNumBands(int numBands);
+	int getNumBands() const;
+
+	//Crossover i sits between band i and band i + 1. Frequencies below the
+	//crossover before them are raised to match it
+	void setCrossoverFrequency(int index, float frequency);
+
+	void setMode(int band, LadderFilter::Mode mode);
+	void setDrive(int band, float drive);
+	void setResonance(int band, float resonance);
+	void setCutoffFrequency(int band, float frequency);
+
+	void process(juce::dsp::AudioBlock<float>& block);
+
+	//Largest stage value of any band ladder, as LadderFilter::getStateMagnitude
+	float getStateMagnitude() const;
+
+	//How long the crossovers and allpasses in use add to the band
+	//ladders' own ringing before it falls to the threshold
+	double getCrossoverTailLength(float threshold) const;
+
+private:
+
+	//Per-band values laid out as one SIMD register each
+	struct alignas(16) Lanes
+	{
+		float band[maxBands];
+	};
+
+	struct alignas(16) ChannelState
+	{
+		Lanes stage[4];
+	};
+
+	void updateCrossovers();
+
+	int numBands{ 1 };
+	int numChannels{ 0 };
+	double sampleRate{ 44100.0 };
+
+	std::array<float, maxBands - 1> crossoverFrequencies;
+	bool haveCrossoversChanged{ true };
+
+	//crossovers[i] splits band i from everything above it; allpasses[band][i]
+	//gives band the phase shift of crossover i when i is above its own split
+	std::array<juce::dsp::LinkwitzRileyFilter<float>, maxBands - 1> crossovers;
+	std::array<std::array<juce::dsp::LinkwitzRileyFilter<float>, maxBands - 1>, maxBands> allpasses;
+
+	Lanes targetG;
+	Lanes targetK;
+	Lanes targetDrive;
+	Lanes targetGain;
+
+	Lanes currentG;
+	Lanes currentK;
+	Lanes currentDrive;
+	Lanes currentGain;
+
+	//Mixing coefficient a0 to a4 of each band's mode
+	std::array<Lanes, 5> mixing;
+	std::array<float, maxBands> cutoffFrequencies;
+
+	std::array<ChannelState, maxChannels> state;
+};
\ No newline at end of file
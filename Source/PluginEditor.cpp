@@ -4,8 +4,8 @@
 VermeulenLadderFilterAudioProcessorEditor::VermeulenLadderFilterAudioProcessorEditor(VermeulenLadderFilterAudioProcessor& p)
 	: AudioProcessorEditor(&p), audioProcessor(p)
 {
-	setSize(renderer.startWidth, renderer.startHeight);
-	addAndMakeVisible(renderer);
+	setOpaque(true);
+	setSize(Renderer::startWidth, Renderer::startHeight);
 	setResizable(true, true);
 }
 
@@ -13,7 +13,46 @@ VermeulenLadderFilterAudioProcessorEditor::~VermeulenLadderFilterAudioProcessorE
 {
 }
 
+void VermeulenLadderFilterAudioProcessorEditor::paint(juce::Graphics& graphics)
+{
+	//Only seen until the renderer covers the editor, in the waterfall's colour
+	graphics.fillAll(juce::Colour(23, 24, 23));
+}
+
 void VermeulenLadderFilterAudioProcessorEditor::resized()
 {
-	renderer.setBounds(getLocalBounds());
+	if (renderer != nullptr)
+	{
+		renderer->setBounds(getLocalBounds());
+	}
+}
+
+void VermeulenLadderFilterAudioProcessorEditor::visibilityChanged()
+{
+	createRendererIfShowing();
+}
+
+void VermeulenLadderFilterAudioProcessorEditor::parentHierarchyChanged()
+{
+	createRendererIfShowing();
+}
+
+bool VermeulenLadderFilterAudioProcessorEditor::hasRenderedFirstFrame() const
+{
+	return renderer != nullptr && renderer->hasRenderedFirstFrame();
+}
+
+bool VermeulenLadderFilterAudioProcessorEditor::isUsingSoftwareWaterfall() const
+{
+	return renderer != nullptr && renderer->isUsingSoftwareWaterfall();
+}
+
+void VermeulenLadderFilterAudioProcessorEditor::createRendererIfShowing()
+{
+	if (renderer == nullptr && isShowing())
+	{
+		renderer = std::make_unique<Renderer>(audioProcessor);
+		renderer->setBounds(getLocalBounds());
+		addAndMakeVisible(*renderer);
+	}
 }
\ No newline at end of file
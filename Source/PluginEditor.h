@@ -1,21 +1,36 @@
 #pragma once
+#include <memory>
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "Renderer.h"
 
+//Hosts often create an editor well before showing it, or only to ask for
+//its size, so the renderer and everything it owns is only built once the
+//editor is first on screen
 class VermeulenLadderFilterAudioProcessorEditor : public juce::AudioProcessorEditor
 {
 public:
 
 	VermeulenLadderFilterAudioProcessorEditor(VermeulenLadderFilterAudioProcessor&);
 	~VermeulenLadderFilterAudioProcessorEditor() override;
+	void paint(juce::Graphics& graphics) override;
 	void resized() override;
+	void visibilityChanged() override;
+	void parentHierarchyChanged() override;
+
+	//True once the waterfall has drawn its first frame
+	bool hasRenderedFirstFrame() const;
+
+	//True when the waterfall fell back to drawing on the CPU
+	bool isUsingSoftwareWaterfall() const;
 
 private:
 
+	void createRendererIfShowing();
+
 	VermeulenLadderFilterAudioProcessor& audioProcessor;
 
-	Renderer renderer{ audioProcessor };
+	std::unique_ptr<Renderer> renderer;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VermeulenLadderFilterAudioProcessorEditor)
 };
\ No newline at end of file
@@ -13,10 +13,47 @@ VermeulenLadderFilterAudioProcessor::VermeulenLadderFilterAudioProcessor()
 	)
 #endif
 {
+	//Same defaults as a freshly created PluginState
+	PluginState defaults;
+
+	for (size_t i = 0; i < crossoverTargets.size(); ++i)
+	{
+		crossoverTargets[i] = defaults.crossoverFrequencies[i];
+	}
+
+	for (size_t band = 0; band < bandModeTargets.size(); ++band)
+	{
+		bandModeTargets[band] = defaults.bandModes[band];
+		bandDriveTargets[band] = bandDrives[band] = defaults.bandDrives[band];
+		bandResonanceTargets[band] = bandResonances[band] = defaults.bandResonances[band];
+		bandCutoffTargets[band] = bandCutoffFrequencies[band] = defaults.bandCutoffFrequencies[band];
+	}
+
+	//The name is fixed for the life of the processor, so readers can keep
+	//using it however often the host prepares us again
+	const auto sharedMemoryRequest = juce::SystemStats::getEnvironmentVariable(sharedMemoryVariable, {}).trim();
+	isSharedMemoryExportEnabled = sharedMemoryRequest.isNotEmpty();
+	sharedMemoryName = SharedMemoryExport::createName(sharedMemoryRequest);
+
+	const auto instructionSetName = juce::SystemStats::getEnvironmentVariable(instructionSetVariable, {}).trim();
+
+	for (auto instructionSet : { InstructionSet::sse2, InstructionSet::avx2, InstructionSet::avx512 })
+	{
+		if (instructionSetName.equalsIgnoreCase(DspKernels::getName(instructionSet)))
+		{
+			instructionSetTarget = static_cast<int>(instructionSet);
+		}
+	}
+
+	kernels = &DspKernels::get(InstructionSet::sse2);
+
+	reportedTailLength = getTailLengthSeconds();
+	startTimerHz(tailCheckRate);
 }
 
 VermeulenLadderFilterAudioProcessor::~VermeulenLadderFilterAudioProcessor()
 {
+	stopTimer();
 }
 
 const juce::String VermeulenLadderFilterAudioProcessor::getName() const
@@ -53,7 +90,57 @@ bool VermeulenLadderFilterAudioProcessor::isMidiEffect() const
 
 double VermeulenLadderFilterAudioProcessor::getTailLengthSeconds() const
 {
-	return 0.0;
+	//Worked out by the ladders down to our silence threshold, so the
+	//processor goes to sleep within this long of the input stopping
+	return ringingTailLength.load();
+}
+
+void VermeulenLadderFilterAudioProcessor::timerCallback()
+{
+	//Hosts only ask for the tail again when told that something changed,
+	//and this cannot be done from the audio thread where MIDI moves it
+	const auto tailLength = getTailLengthSeconds();
+
+	if (tailLength != reportedTailLength)
+	{
+		reportedTailLength = tailLength;
+		updateHostDisplay();
+	}
+}
+
+bool VermeulenLadderFilterAudioProcessor::isSleeping() const
+{
+	return sleeping;
+}
+
+LevelMeter& VermeulenLadderFilterAudioProcessor::getLevelMeter()
+{
+	return levelMeter;
+}
+
+void VermeulenLadderFilterAudioProcessor::setSharedMemoryExportEnabled(bool isEnabled)
+{
+	isSharedMemoryExportEnabled = isEnabled;
+}
+
+juce::String VermeulenLadderFilterAudioProcessor::getSharedMemoryName() const
+{
+	if (isSharedMemoryExportEnabled)
+	{
+		return sharedMemoryName;
+	}
+
+	return {};
+}
+
+void VermeulenLadderFilterAudioProcessor::setInstructionSet(InstructionSet instructionSet)
+{
+	instructionSetTarget = static_cast<int>(instructionSet);
+}
+
+InstructionSet VermeulenLadderFilterAudioProcessor::getInstructionSet() const
+{
+	return static_cast<InstructionSet>(activeInstructionSet.load());
 }
 
 int VermeulenLadderFilterAudioProcessor::getNumSamples() const
@@ -97,13 +184,47 @@ void VermeulenLadderFilterAudioProcessor::changeProgramName(int index, const juc
 
 void VermeulenLadderFilterAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-	juce::dsp::ProcessSpec processSpec;
-	processSpec.sampleRate = getSampleRate();
-	processSpec.numChannels = getNumOutputChannels();
-	processSpec.maximumBlockSize = getBlockSize();
+	updateParameters();
+	ladderFilter.setMode(static_cast<LadderFilter::Mode>(mode));
+	ladderFilter.setDrive(drive);
+	ladderFilter.setResonance(resonance);
+	ladderFilter.setCutoffFrequency(cutoffFrequency);
+	ladderFilter.prepare(sampleRate, getTotalNumOutputChannels());
+	setBandParameters();
+	multibandLadder.prepare(sampleRate, getTotalNumOutputChannels());
+	levelMeter.prepare(sampleRate, getTotalNumOutputChannels());
+
+	//Chosen once here rather than per block; the CPU cannot change under us
+	const auto instructionSet = DspKernels::resolve(static_cast<InstructionSet>(instructionSetTarget.load()));
+	activeInstructionSet = static_cast<int>(instructionSet);
+	kernels = &DspKernels::get(instructionSet);
+	ladderFilter.setKernels(*kernels);
+	levelMeter.setKernels(*kernels);
+
+	sleeping = false;
+
+	//The host does not run processBlock while preparing, so the segment
+	//can be swapped here without the audio thread ever seeing it change.
+	//It is only recreated when it has to be, as readers keep their mapping
+	const auto numOutputChannels = juce::jlimit(1, static_cast<int>(SharedMemoryLayout::maxChannels), getTotalNumOutputChannels());
+
+	if (!isSharedMemoryExportEnabled)
+	{
+		sharedMemoryExport.reset();
+	}
 
-	ladderFilter.setEnabled(true);
-	ladderFilter.prepare(processSpec);
+	else if (sharedMemoryExport != nullptr && sharedMemoryExport->isOpen()
+		&& sharedMemoryExport->getNumChannels() == numOutputChannels)
+	{
+		sharedMemoryExport->setSampleRate(sampleRate);
+	}
+
+	else
+	{
+		//The old segment has to be gone before the new one takes its name
+		sharedMemoryExport.reset();
+		sharedMemoryExport = std::make_unique<SharedMemoryExport>(sharedMemoryName, numOutputChannels, sampleRate);
+	}
 }
 
 void VermeulenLadderFilterAudioProcessor::releaseResources()
@@ -139,6 +260,7 @@ bool VermeulenLadderFilterAudioProcessor::isBusesLayoutSupported(const BusesLayo
 void VermeulenLadderFilterAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 	juce::MidiBuffer& midiMessages)
 {
+	RealtimeSafety::ScopedAudioThread audioThread;
 	juce::ScopedNoDenormals noDenormals;
 	auto totalNumInputChannels = getTotalNumInputChannels();
 	auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -154,24 +276,85 @@ void VermeulenLadderFilterAudioProcessor::processBlock(juce::AudioBuffer<float>&
 		buffer.clear(i, 0, buffer.getNumSamples());
 	}
 
-	// This is the place where you'd normally do the guts of your plugin's
-	// audio processing...
-	// Make sure to reset the state if your inner loop is processing
-	// the samples and the outer loop is handling the channels.
-	// Alternatively, you can process the samples with the channels
-	// interleaved by keeping the same state.
+	auto isInputSilent = true;
+
 	for (int channel = 0; channel < totalNumInputChannels; ++channel)
 	{
-		auto* rawData = buffer.getWritePointer(channel);
+		if (buffer.getMagnitude(channel, 0, buffer.getNumSamples()) > silenceThreshold)
+		{
+			isInputSilent = false;
+			break;
+		}
+	}
+
+	updateParameters();
 
-		for (int sample = 0; sample < buffer.getNumSamples(); sample++)
+	//Once the input is silent and the filter has stopped ringing there
+	//is nothing left to compute, so we skip the gain and filter stages
+	//and only keep track of what the MIDI events change
+	if (sleeping && isInputSilent)
+	{
+		for (const auto metadata : midiMessages)
 		{
-			rawData[sample] *= volume;
+			handleMidiEvent(metadata.getMessage());
 		}
 
-		juce::dsp::AudioBlock<float> audioBlock(buffer);
-		juce::dsp::ProcessContextReplacing<float> processContext(audioBlock);
-		ladderFilter.process(processContext);
+		buffer.clear();
+	}
+
+	else
+	{
+		//Whatever the ladder still holds is below the silence threshold
+		//so we start from a clean state rather than from denormal residue
+		if (sleeping)
+		{
+			ladderFilter.reset();
+			multibandLadder.reset();
+			sleeping = false;
+		}
+
+		//Split the block at each MIDI event so that controller and note
+		//changes take effect at the sample they were sent on. Events that
+		//land closer than the minimum segment length to the previous split
+		//are applied at that split instead
+		auto segmentStart = 0;
+
+		for (const auto metadata : midiMessages)
+		{
+			auto eventPosition = juce::jlimit(0, buffer.getNumSamples(), metadata.samplePosition);
+
+			if (eventPosition - segmentStart >= minSegmentLength)
+			{
+				processSegment(buffer, segmentStart, eventPosition - segmentStart);
+				segmentStart = eventPosition;
+			}
+
+			handleMidiEvent(metadata.getMessage());
+		}
+
+		if (segmentStart < buffer.getNumSamples())
+		{
+			processSegment(buffer, segmentStart, buffer.getNumSamples() - segmentStart);
+		}
+
+		//With silent input the output is purely the filter's decaying
+		//state, so once that state and the output are inaudible we can
+		//go to sleep. The output alone is not enough, as high-pass modes
+		//cancel out a DC offset still held in the stages
+		if (isInputSilent)
+		{
+			const auto stateMagnitude = numBands > 1 ? multibandLadder.getStateMagnitude() : ladderFilter.getStateMagnitude();
+
+			sleeping = stateMagnitude <= silenceThreshold
+				&& buffer.getMagnitude(0, buffer.getNumSamples()) <= silenceThreshold;
+		}
+	}
+
+	levelMeter.process(buffer);
+
+	if (sharedMemoryExport != nullptr)
+	{
+		publishToSharedMemory(buffer);
 	}
 
 	numSamples = buffer.getNumSamples();
@@ -179,6 +362,261 @@ void VermeulenLadderFilterAudioProcessor::processBlock(juce::AudioBuffer<float>&
 	channelDataRight = buffer.getWritePointer(1);
 }
 
+void VermeulenLadderFilterAudioProcessor::updateParameters()
+{
+	//The audio thread never waits for a restore to finish. While one is
+	//under way, or if one started while we read, this block keeps the
+	//values it had and the next one tries again
+	const auto restoreCount = stateRestoreCount.load();
+
+	if ((restoreCount & 1) != 0)
+	{
+		return;
+	}
+
+	const auto targets = loadTargets();
+
+	if (stateRestoreCount.load() != restoreCount)
+	{
+		return;
+	}
+
+	//An editor change always wins over an earlier MIDI controller value,
+	//until the next controller message for that parameter arrives
+	if (targets.cutoffFrequency != editorCutoffFrequency)
+	{
+		editorCutoffFrequency = targets.cutoffFrequency;
+		cutoffFrequency = targets.cutoffFrequency;
+	}
+
+	if (targets.resonance != editorResonance)
+	{
+		editorResonance = targets.resonance;
+		resonance = targets.resonance;
+	}
+
+	if (targets.mode != mode)
+	{
+		mode = targets.mode;
+		ladderFilter.setMode(static_cast<LadderFilter::Mode>(mode));
+	}
+
+	drive = targets.drive;
+	volume = targets.volume;
+	keytracking = targets.keytracking;
+	updateKeytrackingRatio();
+
+	//The multiband ladder resets itself when the band count changes; the
+	//single ladder has to be reset here as it sat idle in the meantime
+	auto newNumBands = juce::jlimit(1, MultibandLadder::maxBands, targets.numBands);
+
+	if (newNumBands != numBands)
+	{
+		if (newNumBands == 1)
+		{
+			ladderFilter.reset();
+		}
+
+		numBands = newNumBands;
+		multibandLadder.setNumBands(numBands);
+	}
+
+	for (size_t i = 0; i < targets.crossoverFrequencies.size(); ++i)
+	{
+		multibandLadder.setCrossoverFrequency(static_cast<int>(i), targets.crossoverFrequencies[i]);
+	}
+
+	for (size_t band = 0; band < targets.bandModes.size(); ++band)
+	{
+		multibandLadder.setMode(static_cast<int>(band), static_cast<LadderFilter::Mode>(targets.bandModes[band]));
+		bandDrives[band] = targets.bandDrives[band];
+		bandResonances[band] = targets.bandResonances[band];
+		bandCutoffFrequencies[band] = targets.bandCutoffFrequencies[band];
+	}
+}
+
+PluginState VermeulenLadderFilterAudioProcessor::loadTargets() const
+{
+	PluginState state;
+	state.mode = modeTarget.load();
+	state.drive = driveTarget.load();
+	state.volume = volumeTarget.load();
+	state.resonance = resonanceTarget.load();
+	state.keytracking = keytrackingTarget.load();
+	state.cutoffFrequency = cutoffTarget.load();
+	state.history = editorHistory.load();
+	state.cameraX = editorCameraX.load();
+	state.cameraY = editorCameraY.load();
+	state.cameraZ = editorCameraZ.load();
+
+	state.numBands = numBandsTarget.load();
+
+	for (size_t i = 0; i < crossoverTargets.size(); ++i)
+	{
+		state.crossoverFrequencies[i] = crossoverTargets[i].load();
+	}
+
+	for (size_t band = 0; band < bandModeTargets.size(); ++band)
+	{
+		state.bandModes[band] = bandModeTargets[band].load();
+		state.bandDrives[band] = bandDriveTargets[band].load();
+		state.bandResonances[band] = bandResonanceTargets[band].load();
+		state.bandCutoffFrequencies[band] = bandCutoffTargets[band].load();
+	}
+
+	return state;
+}
+
+void VermeulenLadderFilterAudioProcessor::storeTargets(const PluginState& state)
+{
+	modeTarget = state.mode;
+	driveTarget = state.drive;
+	volumeTarget = state.volume;
+	resonanceTarget = state.resonance;
+	keytrackingTarget = state.keytracking;
+	cutoffTarget = state.cutoffFrequency;
+
+	editorHistory = state.history;
+	editorCameraX = state.cameraX;
+	editorCameraY = state.cameraY;
+	editorCameraZ = state.cameraZ;
+
+	numBandsTarget = state.numBands;
+
+	for (size_t i = 0; i < crossoverTargets.size(); ++i)
+	{
+		crossoverTargets[i] = state.crossoverFrequencies[i];
+	}
+
+	for (size_t band = 0; band < bandModeTargets.size(); ++band)
+	{
+		bandModeTargets[band] = state.bandModes[band];
+		bandDriveTargets[band] = state.bandDrives[band];
+		bandResonanceTargets[band] = state.bandResonances[band];
+		bandCutoffTargets[band] = state.bandCutoffFrequencies[band];
+	}
+}
+
+void VermeulenLadderFilterAudioProcessor::handleMidiEvent(const juce::MidiMessage& message)
+{
+	if (message.isController())
+	{
+		auto value = message.getControllerValue() / 127.0f;
+
+		//Map the controller exponentially from 20 Hz to 20 kHz
+		if (message.getControllerNumber() == cutoffController)
+		{
+			cutoffFrequency = 20.0f * std::pow(1000.0f, value);
+		}
+
+		else if (message.getControllerNumber() == resonanceController)
+		{
+			resonance = value;
+		}
+	}
+
+	else if (message.isNoteOn())
+	{
+		lastNoteNumber = message.getNoteNumber();
+		updateKeytrackingRatio();
+	}
+}
+
+void VermeulenLadderFilterAudioProcessor::updateKeytrackingRatio()
+{
+	//Also called when the keytracking amount changes, so a held note
+	//follows the new amount rather than keeping the one it started with
+	auto semitones = static_cast<float>(lastNoteNumber - keytrackingReferenceNote);
+	keytrackingRatio = std::exp2(semitones * keytracking / 12.0f);
+}
+
+void VermeulenLadderFilterAudioProcessor::setBandParameters()
+{
+	for (int band = 0; band < MultibandLadder::maxBands; ++band)
+	{
+		const auto index = static_cast<size_t>(band);
+		multibandLadder.setDrive(band, bandDrives[index]);
+		multibandLadder.setResonance(band, bandResonances[index]);
+		multibandLadder.setCutoffFrequency(band, juce::jlimit(minCutoffFrequency,
+			maxCutoffFrequency, bandCutoffFrequencies[index] * keytrackingRatio));
+	}
+}
+
+void VermeulenLadderFilterAudioProcessor::processSegment(juce::AudioBuffer<float>& buffer,
+	int startSample, int numSegmentSamples)
+{
+	if (numBands > 1)
+	{
+		setBandParameters();
+
+		auto longestTail = 0.0;
+
+		for (int band = 0; band < numBands; ++band)
+		{
+			const auto index = static_cast<size_t>(band);
+			const auto bandCutoff = juce::jlimit(minCutoffFrequency, maxCutoffFrequency, bandCutoffFrequencies[index] * keytrackingRatio);
+
+			longestTail = juce::jmax(longestTail, LadderFilter::getTailLength(bandCutoff, bandResonances[index],
+				bandDrives[index], getSampleRate(), silenceThreshold));
+		}
+
+		ringingTailLength.store(longestTail + multibandLadder.getCrossoverTailLength(silenceThreshold), std::memory_order_relaxed);
+	}
+
+	else
+	{
+		const auto modulatedCutoff = juce::jlimit(minCutoffFrequency, maxCutoffFrequency, cutoffFrequency * keytrackingRatio);
+
+		ladderFilter.setDrive(drive);
+		ladderFilter.setResonance(resonance);
+		ladderFilter.setCutoffFrequency(modulatedCutoff);
+
+		ringingTailLength.store(LadderFilter::getTailLength(modulatedCutoff, resonance, drive, getSampleRate(), silenceThreshold),
+			std::memory_order_relaxed);
+	}
+
+	for (int channel = 0; channel < getTotalNumInputChannels(); ++channel)
+	{
+		kernels->applyGain(buffer.getWritePointer(channel, startSample), numSegmentSamples, volume);
+	}
+
+	//The ladder processes every channel of the segment in one go
+	juce::dsp::AudioBlock<float> audioBlock(buffer);
+	auto segmentBlock = audioBlock.getSubBlock(static_cast<size_t>(startSample),
+		static_cast<size_t>(numSegmentSamples));
+
+	if (numBands > 1)
+	{
+		multibandLadder.process(segmentBlock);
+	}
+
+	else
+	{
+		ladderFilter.process(segmentBlock);
+	}
+}
+
+void VermeulenLadderFilterAudioProcessor::publishToSharedMemory(const juce::AudioBuffer<float>& buffer)
+{
+	SharedMemoryLayout::AnalysisFrame frame{};
+	frame.mode = mode;
+	frame.isSleeping = sleeping ? 1 : 0;
+	frame.drive = drive;
+	frame.volume = volume;
+	frame.resonance = resonance;
+	frame.cutoffFrequency = juce::jlimit(minCutoffFrequency, maxCutoffFrequency, cutoffFrequency * keytrackingRatio);
+
+	const auto numChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(SharedMemoryLayout::maxChannels));
+
+	for (int channel = 0; channel < numChannels; ++channel)
+	{
+		frame.peak[channel] = levelMeter.getPeak(channel);
+		frame.rms[channel] = levelMeter.getRms(channel);
+	}
+
+	sharedMemoryExport->publish(buffer, frame);
+}
+
 bool VermeulenLadderFilterAudioProcessor::hasEditor() const
 {
 	return true;
@@ -191,40 +629,172 @@ juce::AudioProcessorEditor* VermeulenLadderFilterAudioProcessor::createEditor()
 
 void VermeulenLadderFilterAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-	// You should use this method to store your parameters in the memory block.
-	// You could do that either as raw data, or use the XML or ValueTree classes
-	// as intermediaries to make it easy to save and load complex data.
+	loadTargets().writeTo(destData);
 }
 
 void VermeulenLadderFilterAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-	// You should use this method to restore your parameters from this memory block,
-	// whose contents will have been created by the getStateInformation() call.
+	PluginState state;
+
+	if (!state.readFrom(data, sizeInBytes))
+	{
+		return;
+	}
+
+	//Only the targets change here; the audio thread picks them up at the
+	//start of its next block, and only once all of them are in place
+	++stateRestoreCount;
+	storeTargets(state);
+	++stateRestoreCount;
+
+	sendChangeMessage();
 }
 
 void VermeulenLadderFilterAudioProcessor::setDrive(float drive)
 {
-	ladderFilter.setDrive(drive);
+	driveTarget = drive;
 }
 
 void VermeulenLadderFilterAudioProcessor::setVolume(float volume)
 {
-	this->volume = volume;
+	volumeTarget = volume;
 }
 
 void VermeulenLadderFilterAudioProcessor::setResonance(float resonance)
 {
-	ladderFilter.setResonance(resonance);
+	resonanceTarget = resonance;
+}
+
+void VermeulenLadderFilterAudioProcessor::setKeytracking(float amount)
+{
+	keytrackingTarget = amount;
 }
 
 void VermeulenLadderFilterAudioProcessor::setMode(int id)
 {
-	ladderFilter.setMode(static_cast<juce::dsp::LadderFilterMode>(id));
+	modeTarget = id;
 }
 
 void VermeulenLadderFilterAudioProcessor::setCutoffFrequency(float frequency)
 {
-	ladderFilter.setCutoffFrequencyHz(frequency);
+	cutoffTarget = frequency;
+}
+
+int VermeulenLadderFilterAudioProcessor::getMode() const
+{
+	return modeTarget;
+}
+
+float VermeulenLadderFilterAudioProcessor::getDrive() const
+{
+	return driveTarget;
+}
+
+float VermeulenLadderFilterAudioProcessor::getVolume() const
+{
+	return volumeTarget;
+}
+
+float VermeulenLadderFilterAudioProcessor::getResonance() const
+{
+	return resonanceTarget;
+}
+
+float VermeulenLadderFilterAudioProcessor::getKeytracking() const
+{
+	return keytrackingTarget;
+}
+
+float VermeulenLadderFilterAudioProcessor::getCutoffFrequency() const
+{
+	return cutoffTarget;
+}
+
+void VermeulenLadderFilterAudioProcessor::setNumBands(int numBands)
+{
+	numBandsTarget = juce::jlimit(1, MultibandLadder::maxBands, numBands);
+}
+
+void VermeulenLadderFilterAudioProcessor::setCrossoverFrequency(int index, float frequency)
+{
+	jassert(index >= 0 && index < MultibandLadder::maxBands - 1);
+	crossoverTargets[static_cast<size_t>(index)] = frequency;
+}
+
+void VermeulenLadderFilterAudioProcessor::setBandMode(int band, int id)
+{
+	jassert(band >= 0 && band < MultibandLadder::maxBands);
+	bandModeTargets[static_cast<size_t>(band)] = id;
+}
+
+void VermeulenLadderFilterAudioProcessor::setBandDrive(int band, float drive)
+{
+	jassert(band >= 0 && band < MultibandLadder::maxBands);
+	bandDriveTargets[static_cast<size_t>(band)] = drive;
+}
+
+void VermeulenLadderFilterAudioProcessor::setBandResonance(int band, float resonance)
+{
+	jassert(band >= 0 && band < MultibandLadder::maxBands);
+	bandResonanceTargets[static_cast<size_t>(band)] = resonance;
+}
+
+void VermeulenLadderFilterAudioProcessor::setBandCutoffFrequency(int band, float frequency)
+{
+	jassert(band >= 0 && band < MultibandLadder::maxBands);
+	bandCutoffTargets[static_cast<size_t>(band)] = frequency;
+}
+
+int VermeulenLadderFilterAudioProcessor::getNumBands() const
+{
+	return numBandsTarget;
+}
+
+float VermeulenLadderFilterAudioProcessor::getCrossoverFrequency(int index) const
+{
+	return crossoverTargets[static_cast<size_t>(index)];
+}
+
+int VermeulenLadderFilterAudioProcessor::getBandMode(int band) const
+{
+	return bandModeTargets[static_cast<size_t>(band)];
+}
+
+float VermeulenLadderFilterAudioProcessor::getBandDrive(int band) const
+{
+	return bandDriveTargets[static_cast<size_t>(band)];
+}
+
+float VermeulenLadderFilterAudioProcessor::getBandResonance(int band) const
+{
+	return bandResonanceTargets[static_cast<size_t>(band)];
+}
+
+float VermeulenLadderFilterAudioProcessor::getBandCutoffFrequency(int band) const
+{
+	return bandCutoffTargets[static_cast<size_t>(band)];
+}
+
+void VermeulenLadderFilterAudioProcessor::setEditorHistory(int history)
+{
+	editorHistory = history;
+}
+
+int VermeulenLadderFilterAudioProcessor::getEditorHistory() const
+{
+	return editorHistory;
+}
+
+void VermeulenLadderFilterAudioProcessor::setEditorCamera(const juce::Vector3D<float>& position)
+{
+	editorCameraX = position.x;
+	editorCameraY = position.y;
+	editorCameraZ = position.z;
+}
+
+juce::Vector3D<float> VermeulenLadderFilterAudioProcessor::getEditorCamera() const
+{
+	return { editorCameraX.load(), editorCameraY.load(), editorCameraZ.load() };
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -1,7 +1,19 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <JuceHeader.h>
-
-class VermeulenLadderFilterAudioProcessor : public juce::AudioProcessor
+#include "DspKernels.h"
+#include "LadderFilter.h"
+#include "LevelMeter.h"
+#include "MultibandLadder.h"
+#include "PluginState.h"
+#include "RealtimeSafety.h"
+#include "SharedMemoryExport.h"
+
+//Sends a change message whenever a saved state is restored, so that an
+//open editor can pick up the new values
+class VermeulenLadderFilterAudioProcessor : public juce::AudioProcessor, public juce::ChangeBroadcaster,
+	private juce::Timer
 {
 public:
 
@@ -46,16 +58,160 @@ public:
 	void setDrive(float drive);
 	void setVolume(float volume);
 	void setResonance(float resonance);
+	void setKeytracking(float amount);
 	void setCutoffFrequency(float frequency);
 
+	int getMode() const;
+	float getDrive() const;
+	float getVolume() const;
+	float getResonance() const;
+	float getKeytracking() const;
+	float getCutoffFrequency() const;
+
+	//With more than one band each band runs its own ladder with the band
+	//settings below, and the single ladder settings above are not used.
+	//Keytracking applies to every band's cutoff
+	void setNumBands(int numBands);
+	void setCrossoverFrequency(int index, float frequency);
+	void setBandMode(int band, int id);
+	void setBandDrive(int band, float drive);
+	void setBandResonance(int band, float resonance);
+	void setBandCutoffFrequency(int band, float frequency);
+
+	int getNumBands() const;
+	float getCrossoverFrequency(int index) const;
+	int getBandMode(int band) const;
+	float getBandDrive(int band) const;
+	float getBandResonance(int band) const;
+	float getBandCutoffFrequency(int band) const;
+
+	//Editor settings are kept here so that they are saved with the
+	//project and survive the editor being closed
+	void setEditorHistory(int history);
+	int getEditorHistory() const;
+	void setEditorCamera(const juce::Vector3D<float>& position);
+	juce::Vector3D<float> getEditorCamera() const;
+
+	bool isSleeping() const;
+
+	//Output levels after the filter and volume stages
+	LevelMeter& getLevelMeter();
+
+	//Takes effect at the next prepareToPlay. The segment name stays the
+	//same for the life of the processor and is empty while disabled
+	void setSharedMemoryExportEnabled(bool isEnabled);
+	juce::String getSharedMemoryName() const;
+
+	//Forces the DSP kernels onto one instruction set from the next
+	//prepareToPlay, mainly for tests. Automatic picks the best the machine
+	//supports, as does any set it cannot run
+	void setInstructionSet(InstructionSet instructionSet);
+
+	//The set chosen at the last prepareToPlay
+	InstructionSet getInstructionSet() const;
+
 private:
 
+	void timerCallback() override;
+	void updateParameters();
+	PluginState loadTargets() const;
+	void storeTargets(const PluginState& state);
+	void updateKeytrackingRatio();
+	void handleMidiEvent(const juce::MidiMessage& message);
+	void setBandParameters();
+	void processSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSegmentSamples);
+	void publishToSharedMemory(const juce::AudioBuffer<float>& buffer);
+
+	//Input below roughly -120 dBFS is treated as digital silence
+	const float silenceThreshold{ 1.0e-6f };
+
+	//How often the tail length is checked for changes to tell the host about
+	const int tailCheckRate{ 4 };
+	double reportedTailLength{ 0.0 };
+
+	//Blocks are only split at MIDI events that are at least this far
+	//apart, which bounds the number of segments per callback and keeps
+	//each parameter ramp at least this long. An event closer than this to
+	//the previous split takes effect up to this many samples minus one early
+	const int minSegmentLength{ 32 };
+
+	const int cutoffController{ 74 };
+	const int resonanceController{ 71 };
+	const int keytrackingReferenceNote{ 60 };
+	const float minCutoffFrequency{ 1.0f };
+	const float maxCutoffFrequency{ 24000.0f };
+
+	bool sleeping{ false };
+
 	int numSamples{ 0 };
-	float volume{ 0.0 };
 	float* channelDataLeft{ nullptr };
 	float* channelDataRight{ nullptr };
 
-	juce::dsp::LadderFilter<float> ladderFilter;
+	//Written by the editor, picked up by the audio thread once per block
+	std::atomic<int> modeTarget{ static_cast<int>(LadderFilter::Mode::LPF24) };
+	std::atomic<float> driveTarget{ 1.0f };
+	std::atomic<float> volumeTarget{ 0.5f };
+	std::atomic<float> resonanceTarget{ 0.0f };
+	std::atomic<float> keytrackingTarget{ 0.0f };
+	std::atomic<float> cutoffTarget{ 24000.0f };
+
+	std::atomic<int> numBandsTarget{ 1 };
+	std::array<std::atomic<float>, MultibandLadder::maxBands - 1> crossoverTargets;
+	std::array<std::atomic<int>, MultibandLadder::maxBands> bandModeTargets;
+	std::array<std::atomic<float>, MultibandLadder::maxBands> bandDriveTargets;
+	std::array<std::atomic<float>, MultibandLadder::maxBands> bandResonanceTargets;
+	std::array<std::atomic<float>, MultibandLadder::maxBands> bandCutoffTargets;
+
+	//A restored state is written to the targets one by one, with this
+	//count odd while that is going on, so that the audio thread can tell
+	//when what it read mixes two states and keep its previous values
+	std::atomic<juce::uint32> stateRestoreCount{ 0 };
+
+	//How long the ladder takes to ring down at the settings it last ran
+	//with, after MIDI and keytracking, or the longest of the bands
+	std::atomic<double> ringingTailLength{ 0.0 };
+
+	std::atomic<int> editorHistory{ 50 };
+	std::atomic<float> editorCameraX{ 0.0f };
+	std::atomic<float> editorCameraY{ 0.15f };
+	std::atomic<float> editorCameraZ{ 0.25f };
+
+	//Audio thread copies, which MIDI events may change mid-block
+	int mode{ static_cast<int>(LadderFilter::Mode::LPF24) };
+	float drive{ 1.0f };
+	float volume{ 0.5f };
+	float resonance{ 0.0f };
+	float keytracking{ 0.0f };
+	float keytrackingRatio{ 1.0f };
+	int lastNoteNumber{ keytrackingReferenceNote };
+	float cutoffFrequency{ 24000.0f };
+	float editorResonance{ 0.0f };
+	float editorCutoffFrequency{ 24000.0f };
+
+	int numBands{ 1 };
+	std::array<float, MultibandLadder::maxBands> bandDrives;
+	std::array<float, MultibandLadder::maxBands> bandResonances;
+	std::array<float, MultibandLadder::maxBands> bandCutoffFrequencies;
+
+	LadderFilter ladderFilter;
+	MultibandLadder multibandLadder;
+	LevelMeter levelMeter;
+
+	//Set to sse2, avx2 or avx512 to pin the kernels on a machine that
+	//misbehaves with the set picked automatically
+	const char* instructionSetVariable{ "VERMEULEN_INSTRUCTION_SET" };
+
+	std::atomic<int> instructionSetTarget{ static_cast<int>(InstructionSet::automatic) };
+	std::atomic<int> activeInstructionSet{ static_cast<int>(InstructionSet::sse2) };
+	const DspKernels* kernels{ nullptr };
+
+	//Live rigs turn the export on without touching the host by setting
+	//this environment variable before it starts
+	const char* sharedMemoryVariable{ "VERMEULEN_SHARED_MEMORY" };
+
+	std::atomic<bool> isSharedMemoryExportEnabled{ false };
+	juce::String sharedMemoryName;
+	std::unique_ptr<SharedMemoryExport> sharedMemoryExport;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VermeulenLadderFilterAudioProcessor)
 };
@@ -0,0 +1,187 @@
+#include "PluginState.h"
+
+namespace
+{
+	const int headerSize{ 8 };
+
+	//Reads fields straight out of the host's buffer without building any
+	//intermediate tree, stopping quietly at the end of the payload
+	class FieldReader
+	{
+	public:
+
+		FieldReader(const char* data, int size) : data(data), size(size)
+		{
+		}
+
+		void read(int& value)
+		{
+			if (position + 4 <= size)
+			{
+				value = static_cast<int>(juce::ByteOrder::littleEndianInt(data + position));
+				position += 4;
+			}
+		}
+
+		void read(float& value)
+		{
+			if (position + 4 <= size)
+			{
+				auto bits = juce::ByteOrder::littleEndianInt(data + position);
+				std::memcpy(&value, &bits, sizeof(value));
+				position += 4;
+			}
+		}
+
+	private:
+
+		const char* data;
+		int size;
+		int position{ 0 };
+	};
+
+	float Sanitise(float value, float min, float max, float fallback)
+	{
+		return std::isfinite(value) ? juce::jlimit(min, max, value) : fallback;
+	}
+}
+
+PluginState::PluginState()
+{
+	crossoverFrequencies = { { 200.0f, 2000.0f, 8000.0f } };
+	bandModes.fill(static_cast<int>(LadderFilter::Mode::LPF24));
+	bandDrives.fill(1.0f);
+	bandResonances.fill(0.0f);
+	bandCutoffFrequencies.fill(24000.0f);
+}
+
+void PluginState::writeTo(juce::MemoryBlock& destData) const
+{
+	juce::MemoryOutputStream stream(destData, false);
+
+	stream.writeInt(static_cast<int>(magic));
+	stream.writeShort(static_cast<short>(version));
+	stream.writeShort(0);
+
+	stream.writeInt(mode);
+	stream.writeFloat(drive);
+	stream.writeFloat(volume);
+	stream.writeFloat(resonance);
+	stream.writeFloat(keytracking);
+	stream.writeFloat(cutoffFrequency);
+	stream.writeInt(history);
+	stream.writeFloat(cameraX);
+	stream.writeFloat(cameraY);
+	stream.writeFloat(cameraZ);
+
+	stream.writeInt(numBands);
+
+	for (const auto frequency : crossoverFrequencies)
+	{
+		stream.writeFloat(frequency);
+	}
+
+	for (size_t band = 0; band < bandModes.size(); ++band)
+	{
+		stream.writeInt(bandModes[band]);
+		stream.writeFloat(bandDrives[band]);
+		stream.writeFloat(bandResonances[band]);
+		stream.writeFloat(bandCutoffFrequencies[band]);
+	}
+
+	stream.flush();
+
+	//Now that the payload is written we know its size
+	const auto payloadSize = static_cast<juce::uint16>(destData.getSize() - headerSize);
+	auto* bytes = static_cast<juce::uint8*>(destData.getData());
+	bytes[6] = static_cast<juce::uint8>(payloadSize & 0xff);
+	bytes[7] = static_cast<juce::uint8>(payloadSize >> 8);
+}
+
+bool PluginState::readFrom(const void* data, int sizeInBytes)
+{
+	if (data == nullptr || sizeInBytes < headerSize)
+	{
+		return false;
+	}
+
+	const auto* bytes = static_cast<const char*>(data);
+
+	if (juce::ByteOrder::littleEndianInt(bytes) != magic)
+	{
+		return false;
+	}
+
+	const auto dataVersion = juce::ByteOrder::littleEndianShort(bytes + 4);
+
+	if (dataVersion == 0 || dataVersion > version)
+	{
+		return false;
+	}
+
+	const auto payloadSize = juce::jmin(static_cast<int>(juce::ByteOrder::littleEndianShort(bytes + 6)),
+		sizeInBytes - headerSize);
+
+	PluginState state(*this);
+	FieldReader reader(bytes + headerSize, payloadSize);
+
+	reader.read(state.mode);
+	reader.read(state.drive);
+	reader.read(state.volume);
+	reader.read(state.resonance);
+	reader.read(state.keytracking);
+	reader.read(state.cutoffFrequency);
+	reader.read(state.history);
+	reader.read(state.cameraX);
+	reader.read(state.cameraY);
+	reader.read(state.cameraZ);
+
+	//Anything after the version 1 fields is only read from data that was
+	//written with them
+	if (dataVersion >= 2)
+	{
+		reader.read(state.numBands);
+
+		for (auto& frequency : state.crossoverFrequencies)
+		{
+			reader.read(frequency);
+		}
+
+		for (size_t band = 0; band < bandModes.size(); ++band)
+		{
+			reader.read(state.bandModes[band]);
+			reader.read(state.bandDrives[band]);
+			reader.read(state.bandResonances[band]);
+			reader.read(state.bandCutoffFrequencies[band]);
+		}
+	}
+
+	//Whatever the data says, only hand on values the plugin can handle
+	mode = juce::jlimit(0, static_cast<int>(LadderFilter::Mode::BPF24), state.mode);
+	drive = Sanitise(state.drive, 1.0f, 100.0f, drive);
+	volume = Sanitise(state.volume, 0.0f, 1.0f, volume);
+	resonance = Sanitise(state.resonance, 0.0f, 1.0f, resonance);
+	keytracking = Sanitise(state.keytracking, 0.0f, 1.0f, keytracking);
+	cutoffFrequency = Sanitise(state.cutoffFrequency, 1.0f, 24000.0f, cutoffFrequency);
+	history = juce::jlimit(1, 100000, state.history);
+	cameraX = Sanitise(state.cameraX, -1000.0f, 1000.0f, cameraX);
+	cameraY = Sanitise(state.cameraY, -1000.0f, 1000.0f, cameraY);
+	cameraZ = Sanitise(state.cameraZ, -1000.0f, 1000.0f, cameraZ);
+
+	numBands = juce::jlimit(1, MultibandLadder::maxBands, state.numBands);
+
+	for (size_t i = 0; i < crossoverFrequencies.size(); ++i)
+	{
+		crossoverFrequencies[i] = Sanitise(state.crossoverFrequencies[i], 20.0f, 20000.0f, crossoverFrequencies[i]);
+	}
+
+	for (size_t band = 0; band < bandModes.size(); ++band)
+	{
+		bandModes[band] = juce::jlimit(0, static_cast<int>(LadderFilter::Mode::BPF24), state.bandModes[band]);
+		bandDrives[band] = Sanitise(state.bandDrives[band], 1.0f, 100.0f, bandDrives[band]);
+		bandResonances[band] = Sanitise(state.bandResonances[band], 0.0f, 1.0f, bandResonances[band]);
+		bandCutoffFrequencies[band] = Sanitise(state.bandCutoffFrequencies[band], 1.0f, 24000.0f, bandCutoffFrequencies[band]);
+	}
+
+	return true;
+}
\ No newline at end of file
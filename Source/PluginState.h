@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <JuceHeader.h>
+#include "LadderFilter.h"
+#include "MultibandLadder.h"
+
+//Everything the plugin saves with a project, in a compact binary form:
+//
+//  uint32 magic, uint16 version, uint16 payload size in bytes, payload
+//
+//The payload is a fixed sequence of little-endian fields. New fields are
+//only ever appended, so a reader fills in the fields the data's version
+//has and leaves the rest at their defaults. Data from a newer version than
+//the reader knows is rejected, as its fields may no longer mean the same
+//
+//  version 1: int32 mode, float drive, float volume, float resonance,
+//             float keytracking, float cutoff frequency, int32 history,
+//             float camera x, float camera y, float camera z
+//
+//  version 2: int32 number of bands, three float crossover frequencies,
+//             then for each of the four bands int32 mode, float drive,
+//             float resonance, float cutoff frequency
+struct PluginState
+{
+	static const juce::uint32 magic{ 0x50464c56 };
+	static const juce::uint16 version{ 2 };
+
+	PluginState();
+
+	int mode{ static_cast<int>(LadderFilter::Mode::LPF24) };
+	float drive{ 1.0f };
+	float volume{ 0.5f };
+	float resonance{ 0.0f };
+	float keytracking{ 0.0f };
+	float cutoffFrequency{ 24000.0f };
+
+	int history{ 50 };
+	float cameraX{ 0.0f };
+	float cameraY{ 0.15f };
+	float cameraZ{ 0.25f };
+
+	int numBands{ 1 };
+	std::array<float, MultibandLadder::maxBands - 1> crossoverFrequencies;
+	std::array<int, MultibandLadder::maxBands> bandModes;
+	std::array<float, MultibandLadder::maxBands> bandDrives;
+	std::array<float, MultibandLadder::maxBands> bandResonances;
+	std::array<float, MultibandLadder::maxBands> bandCutoffFrequencies;
+
+	void writeTo(juce::MemoryBlock& destData) const;
+
+	//Returns false, leaving every field untouched, if the data is not a
+	//state this plugin wrote or comes from a newer version of it.
+	//Out-of-range values are clamped
+	bool readFrom(const void* data, int sizeInBytes);
+};
\ No newline at end of file
@@ -0,0 +1,560 @@
+#include "RealtimeSafety.h"
+
+#if REALTIME_SAFETY_CHECKS
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#include <crtdbg.h>
+#include <dbghelp.h>
+#include <psapi.h>
+#pragma comment(lib, "dbghelp.lib")
+#pragma comment(lib, "psapi.lib")
+#else
+#include <execinfo.h>
+#endif
+
+#if JUCE_LINUX
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+
+//glibc's own sleep and heap entry points, so the interposed versions
+//below can forward to them without a lookup that would itself allocate
+extern "C"
+{
+	int __nanosleep(const struct timespec* duration, struct timespec* remaining);
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* memory, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* memory);
+}
+#endif
+
+namespace
+{
+	const int maxReports{ 64 };
+	const int maxFrames{ 24 };
+
+	//Raw return addresses captured on the audio thread, symbolised later
+	struct RawReport
+	{
+		RealtimeSafety::Violation violation;
+		void* frames[maxFrames];
+		int numFrames;
+	};
+
+	std::array<RawReport, maxReports> rawReports;
+	std::atomic<int> numRawReports{ 0 };
+
+	thread_local bool isAudioThread{ false };
+	thread_local bool isRecording{ false };
+
+	int captureFrames(void** frames)
+	{
+#if JUCE_WINDOWS
+		return static_cast<int>(CaptureStackBackTrace(0, maxFrames, frames, nullptr));
+#else
+		return backtrace(frames, maxFrames);
+#endif
+	}
+
+#if JUCE_WINDOWS && defined(_DEBUG)
+	//The debug CRT reports every malloc, realloc and free, which also
+	//covers operator new and delete and anything JUCE allocates
+	int allocationHook(int allocationType, void*, size_t, int blockType, long, const unsigned char*, int)
+	{
+		if (blockType != _CRT_BLOCK)
+		{
+			if (allocationType == _HOOK_FREE)
+			{
+				RealtimeSafety::record(RealtimeSafety::Violation::deallocation);
+			}
+
+			else
+			{
+				RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+			}
+		}
+
+		return TRUE;
+	}
+#endif
+
+#if JUCE_WINDOWS
+	//Windows has nothing like symbol interposition, so the calls that
+	//CriticalSection, std::mutex and the sleeps end up in are redirected
+	//in the import tables of every module loaded when the harness starts
+	using EnterCriticalSectionFunction = void (WINAPI*)(LPCRITICAL_SECTION);
+	using AcquireSRWLockFunction = void (WINAPI*)(PSRWLOCK);
+	using WaitForSingleObjectFunction = DWORD (WINAPI*)(HANDLE, DWORD);
+	using SleepFunction = void (WINAPI*)(DWORD);
+
+	EnterCriticalSectionFunction nextEnterCriticalSection{ nullptr };
+	AcquireSRWLockFunction nextAcquireSRWLockExclusive{ nullptr };
+	AcquireSRWLockFunction nextAcquireSRWLockShared{ nullptr };
+	WaitForSingleObjectFunction nextWaitForSingleObject{ nullptr };
+	SleepFunction nextSleep{ nullptr };
+
+	void WINAPI EnterCriticalSectionHook(LPCRITICAL_SECTION section)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::lock);
+		nextEnterCriticalSection(section);
+	}
+
+	void WINAPI AcquireSRWLockExclusiveHook(PSRWLOCK lock)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::lock);
+		nextAcquireSRWLockExclusive(lock);
+	}
+
+	void WINAPI AcquireSRWLockSharedHook(PSRWLOCK lock)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::lock);
+		nextAcquireSRWLockShared(lock);
+	}
+
+	DWORD WINAPI WaitForSingleObjectHook(HANDLE handle, DWORD milliseconds)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::blockingCall);
+		return nextWaitForSingleObject(handle, milliseconds);
+	}
+
+	void WINAPI SleepHook(DWORD milliseconds)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::blockingCall);
+		nextSleep(milliseconds);
+	}
+
+	struct ImportHook
+	{
+		const char* name;
+		void* function;
+	};
+
+	void hookImports(HMODULE module, const ImportHook* hooks, int numHooks)
+	{
+		auto* base = reinterpret_cast<BYTE*>(module);
+		auto* dosHeader = reinterpret_cast<IMAGE_DOS_HEADER*>(base);
+		auto* ntHeaders = reinterpret_cast<IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+		const auto& imports = ntHeaders->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+
+		if (imports.VirtualAddress == 0)
+		{
+			return;
+		}
+
+		for (auto* descriptor = reinterpret_cast<IMAGE_IMPORT_DESCRIPTOR*>(base + imports.VirtualAddress);
+			descriptor->Name != 0; ++descriptor)
+		{
+			if (descriptor->OriginalFirstThunk == 0)
+			{
+				continue;
+			}
+
+			auto* names = reinterpret_cast<IMAGE_THUNK_DATA*>(base + descriptor->OriginalFirstThunk);
+			auto* addresses = reinterpret_cast<IMAGE_THUNK_DATA*>(base + descriptor->FirstThunk);
+
+			for (; names->u1.AddressOfData != 0; ++names, ++addresses)
+			{
+				if (IMAGE_SNAP_BY_ORDINAL(names->u1.Ordinal))
+				{
+					continue;
+				}
+
+				auto* import = reinterpret_cast<IMAGE_IMPORT_BY_NAME*>(base + names->u1.AddressOfData);
+
+				for (int i = 0; i < numHooks; ++i)
+				{
+					if (std::strcmp(reinterpret_cast<const char*>(import->Name), hooks[i].name) == 0)
+					{
+						DWORD protection;
+						VirtualProtect(&addresses->u1.Function, sizeof(addresses->u1.Function), PAGE_READWRITE, &protection);
+						addresses->u1.Function = reinterpret_cast<ULONG_PTR>(hooks[i].function);
+						VirtualProtect(&addresses->u1.Function, sizeof(addresses->u1.Function), protection, &protection);
+					}
+				}
+			}
+		}
+	}
+
+	void hookBlockingCalls()
+	{
+		auto* kernel = GetModuleHandleW(L"kernel32.dll");
+		nextEnterCriticalSection = reinterpret_cast<EnterCriticalSectionFunction>(GetProcAddress(kernel, "EnterCriticalSection"));
+		nextAcquireSRWLockExclusive = reinterpret_cast<AcquireSRWLockFunction>(GetProcAddress(kernel, "AcquireSRWLockExclusive"));
+		nextAcquireSRWLockShared = reinterpret_cast<AcquireSRWLockFunction>(GetProcAddress(kernel, "AcquireSRWLockShared"));
+		nextWaitForSingleObject = reinterpret_cast<WaitForSingleObjectFunction>(GetProcAddress(kernel, "WaitForSingleObject"));
+		nextSleep = reinterpret_cast<SleepFunction>(GetProcAddress(kernel, "Sleep"));
+
+		const ImportHook hooks[] =
+		{
+			{ "EnterCriticalSection", reinterpret_cast<void*>(EnterCriticalSectionHook) },
+			{ "AcquireSRWLockExclusive", reinterpret_cast<void*>(AcquireSRWLockExclusiveHook) },
+			{ "AcquireSRWLockShared", reinterpret_cast<void*>(AcquireSRWLockSharedHook) },
+			{ "WaitForSingleObject", reinterpret_cast<void*>(WaitForSingleObjectHook) },
+			{ "Sleep", reinterpret_cast<void*>(SleepHook) }
+		};
+
+		HMODULE modules[1024];
+		DWORD bytesNeeded;
+
+		if (EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &bytesNeeded))
+		{
+			const auto numModules = juce::jmin(static_cast<int>(bytesNeeded / sizeof(HMODULE)), 1024);
+
+			for (int i = 0; i < numModules; ++i)
+			{
+				hookImports(modules[i], hooks, juce::numElementsInArray(hooks));
+			}
+		}
+	}
+#endif
+
+	struct Installer
+	{
+		Installer()
+		{
+#if JUCE_WINDOWS
+			hookBlockingCalls();
+#endif
+
+#if JUCE_WINDOWS && defined(_DEBUG)
+			_CrtSetAllocHook(allocationHook);
+#elif ! JUCE_WINDOWS
+			//The first backtrace call may load libgcc and allocate, so get
+			//that out of the way before any audio thread can trigger it
+			void* frames[maxFrames];
+			backtrace(frames, maxFrames);
+#endif
+		}
+	};
+
+	Installer installer;
+}
+
+RealtimeSafety::ScopedAudioThread::ScopedAudioThread() : wasAudioThread(isAudioThread)
+{
+	isAudioThread = true;
+}
+
+RealtimeSafety::ScopedAudioThread::~ScopedAudioThread()
+{
+	isAudioThread = wasAudioThread;
+}
+
+void RealtimeSafety::record(Violation violation)
+{
+	if (!isAudioThread || isRecording)
+	{
+		return;
+	}
+
+	isRecording = true;
+
+	auto index = numRawReports++;
+
+	if (index < maxReports)
+	{
+		auto& report = rawReports[static_cast<size_t>(index)];
+		report.violation = violation;
+		report.numFrames = captureFrames(report.frames);
+	}
+
+	isRecording = false;
+}
+
+juce::Array<RealtimeSafety::Report> RealtimeSafety::getReports()
+{
+	juce::Array<Report> reports;
+	auto numReports = juce::jmin(numRawReports.load(), maxReports);
+
+#if JUCE_WINDOWS
+	auto process = GetCurrentProcess();
+	SymInitialize(process, nullptr, TRUE);
+#endif
+
+	for (int i = 0; i < numReports; ++i)
+	{
+		const auto& rawReport = rawReports[static_cast<size_t>(i)];
+		juce::String callSite;
+
+#if JUCE_WINDOWS
+		char symbolStorage[sizeof(SYMBOL_INFO) + 256];
+		auto* symbol = reinterpret_cast<SYMBOL_INFO*>(symbolStorage);
+
+		for (int frame = 0; frame < rawReport.numFrames; ++frame)
+		{
+			symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+			symbol->MaxNameLen = 255;
+
+			if (SymFromAddr(process, reinterpret_cast<DWORD64>(rawReport.frames[frame]), nullptr, symbol))
+			{
+				callSite << "  " << symbol->Name << juce::newLine;
+			}
+		}
+#else
+		if (auto* symbols = backtrace_symbols(rawReport.frames, rawReport.numFrames))
+		{
+			for (int frame = 0; frame < rawReport.numFrames; ++frame)
+			{
+				callSite << "  " << symbols[frame] << juce::newLine;
+			}
+
+			free(symbols);
+		}
+#endif
+
+		reports.add({ rawReport.violation, callSite });
+	}
+
+	return reports;
+}
+
+void RealtimeSafety::clearReports()
+{
+	numRawReports = 0;
+}
+
+#if ! JUCE_LINUX && ! (JUCE_WINDOWS && defined(_DEBUG))
+//Without the debug CRT's hook or malloc interposition we replace the global
+//allocation functions. In Windows release builds this misses direct malloc
+//calls such as HeapBlock's, so run the realtime check in a debug build there
+void* operator new(std::size_t size)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+
+	if (auto* memory = std::malloc(size > 0 ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory != nullptr)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::deallocation);
+		std::free(memory);
+	}
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+
+#if __cpp_aligned_new
+//Over-aligned types such as SIMD registers come through these instead
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+
+#if JUCE_WINDOWS
+	auto* memory = _aligned_malloc(size > 0 ? size : 1, static_cast<std::size_t>(alignment));
+#else
+	void* memory = nullptr;
+	posix_memalign(&memory, static_cast<std::size_t>(alignment), size > 0 ? size : 1);
+#endif
+
+	if (memory != nullptr)
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	if (memory != nullptr)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::deallocation);
+
+#if JUCE_WINDOWS
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
+#endif
+#endif
+
+#if JUCE_LINUX
+//On Linux we can also interpose the blocking primitives that std::mutex,
+//juce::CriticalSection and the various sleep calls end up in
+namespace
+{
+	using MutexLockFunction = int (*)(pthread_mutex_t*);
+
+	MutexLockFunction nextMutexLock{ nullptr };
+	thread_local bool isResolvingMutexLock{ false };
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+	if (nextMutexLock == nullptr)
+	{
+		//dlsym may take a lock of its own while we are still looking up
+		//the real function; that only happens once, before any audio runs
+		if (isResolvingMutexLock)
+		{
+			return 0;
+		}
+
+		isResolvingMutexLock = true;
+		nextMutexLock = reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+		isResolvingMutexLock = false;
+	}
+
+	RealtimeSafety::record(RealtimeSafety::Violation::lock);
+	return nextMutexLock(mutex);
+}
+
+extern "C" int nanosleep(const struct timespec* duration, struct timespec* remaining)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::blockingCall);
+	return __nanosleep(duration, remaining);
+}
+
+//The C heap itself is interposed too, which covers operator new (aligned
+//or not) as libstdc++ builds it on these, as well as HeapBlock and any
+//other direct malloc, realloc and free calls
+extern "C" void* malloc(size_t size)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* memory, size_t size)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	return __libc_realloc(memory, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** memory, size_t alignment, size_t size)
+{
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+	{
+		return EINVAL;
+	}
+
+	RealtimeSafety::record(RealtimeSafety::Violation::allocation);
+	*memory = __libc_memalign(alignment, size);
+
+	return *memory != nullptr ? 0 : ENOMEM;
+}
+
+extern "C" void free(void* memory)
+{
+	if (memory != nullptr)
+	{
+		RealtimeSafety::record(RealtimeSafety::Violation::deallocation);
+		__libc_free(memory);
+	}
+}
+#endif
+
+#else
+
+juce::Array<RealtimeSafety::Report> RealtimeSafety::getReports()
+{
+	return {};
+}
+
+void RealtimeSafety::clearReports()
+{
+}
+
+void RealtimeSafety::record(Violation)
+{
+}
+
+#endif
+
+juce::String RealtimeSafety::getDescription(Violation violation)
+{
+	switch (violation)
+	{
+	case Violation::allocation: return "heap allocation";
+	case Violation::deallocation: return "heap free";
+	case Violation::lock: return "mutex lock";
+	case Violation::blockingCall: return "blocking system call";
+	}
+
+	return {};
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//Set to 1 to trap heap allocations, frees and blocking calls made on the
+//audio thread. The stress harness turns this on; plugin builds leave it off
+//and ScopedAudioThread then compiles down to nothing
+#ifndef REALTIME_SAFETY_CHECKS
+#define REALTIME_SAFETY_CHECKS 0
+#endif
+
+class RealtimeSafety
+{
+public:
+
+	enum class Violation
+	{
+		allocation,
+		deallocation,
+		lock,
+		blockingCall
+	};
+
+	struct Report
+	{
+		Violation violation;
+		juce::String callSite;
+	};
+
+	//Marks the current thread as the audio thread for the lifetime of the scope
+	class ScopedAudioThread
+	{
+	public:
+
+#if REALTIME_SAFETY_CHECKS
+		ScopedAudioThread();
+		~ScopedAudioThread();
+
+	private:
+
+		bool wasAudioThread;
+#endif
+	};
+
+	//Violations are recorded without allocating and only resolved to
+	//readable call sites here, away from the audio thread
+	static juce::Array<Report> getReports();
+	static void clearReports();
+
+	static juce::String getDescription(Violation violation);
+	static void record(Violation violation);
+};
\ No newline at end of file
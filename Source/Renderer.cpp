@@ -3,20 +3,35 @@
 
 Renderer::Renderer(VermeulenLadderFilterAudioProcessor& audioProcessor) : audioProcessor(audioProcessor)
 {
-	context.setOpenGLVersionRequired(juce::OpenGLContext::openGL3_2);
-	context.setRenderer(this);
-	context.setContinuousRepainting(true);
-	context.attachTo(*this);
+	//The GL context is created on its own thread, so a failure only shows
+	//up later; the timer watches for it and swaps in the CPU waterfall
+	if (juce::SystemStats::getEnvironmentVariable(softwareWaterfallVariable, {}).isNotEmpty())
+	{
+		useSoftwareWaterfall();
+	}
 
-	audioProcessor.setDrive(drive);
-	audioProcessor.setVolume(volume);
-	audioProcessor.setResonance(resonance);
-	audioProcessor.setCutoffFrequency(frequency);
-	audioProcessor.setMode(static_cast<int>(juce::dsp::LadderFilterMode::LPF24));
+	else
+	{
+		context.setOpenGLVersionRequired(juce::OpenGLContext::openGL3_2);
+		context.setRenderer(this);
+		context.setContinuousRepainting(true);
+		context.attachTo(*this);
+		startTimerHz(10);
+	}
 
+	//The processor owns every setting, so the editor starts from whatever
+	//it currently holds, whether that is the defaults or a restored state
+	history = audioProcessor.getEditorHistory();
+	drive = audioProcessor.getDrive();
+	volume = audioProcessor.getVolume();
+	resonance = audioProcessor.getResonance();
+	frequency = audioProcessor.getCutoffFrequency();
+	cameraPosition = audioProcessor.getEditorCamera();
+
+	//Colours are set on the controls themselves, which saves building a
+	//look-and-feel for each one while the editor opens
 	auto SetupComponent = [&](juce::Label& label,
 		juce::Slider& slider,
-		juce::LookAndFeel_V4& lookAndFeel,
 		double min, double max, double startValue,
 		juce::Colour thumbColour,
 		juce::Colour trackColour)
@@ -28,28 +43,27 @@ Renderer::Renderer(VermeulenLadderFilterAudioProcessor& audioProcessor) : audioP
 		slider.setValue(startValue);
 		slider.setNumDecimalPlacesToDisplay(2);
 
-		lookAndFeel.setColour(juce::Slider::thumbColourId, thumbColour);
-		lookAndFeel.setColour(juce::Slider::rotarySliderFillColourId, trackColour);
-		slider.setLookAndFeel(&lookAndFeel);
+		slider.setColour(juce::Slider::thumbColourId, thumbColour);
+		slider.setColour(juce::Slider::rotarySliderFillColourId, trackColour);
 	};
 
-	SetupComponent(driveLabel, driveSlider, lookAndFeelDriveSlider, 1.0, 100.0, drive,
+	SetupComponent(driveLabel, driveSlider, 1.0, 100.0, drive,
 		juce::Colour::fromFloatRGBA(0.15f, 0.25f, 0.8f, 1.0f),
 		juce::Colour::fromFloatRGBA(0.15f, 0.5f, 0.8f, 1.0f));
 
-	SetupComponent(resonanceLabel, resonanceSlider, lookAndFeelResonanceSlider, 0.0, 1.0, resonance,
+	SetupComponent(resonanceLabel, resonanceSlider, 0.0, 1.0, resonance,
 		juce::Colour::fromFloatRGBA(0.15f, 0.25f, 0.8f, 1.0f),
 		juce::Colour::fromFloatRGBA(0.15f, 0.5f, 0.8f, 1.0f));
 
-	SetupComponent(frequencyLabel, frequencySlider, lookAndFeelFrequencySlider, 1.0, 24000.0, frequency,
+	SetupComponent(frequencyLabel, frequencySlider, 1.0, 24000.0, frequency,
 		juce::Colour::fromFloatRGBA(0.15f, 0.25f, 0.8f, 1.0f),
 		juce::Colour::fromFloatRGBA(0.15f, 0.5f, 0.8f, 1.0f));
 
-	SetupComponent(historyLabel, historySlider, lookAndFeelHistorySlider, 1, maxHistory, history,
+	SetupComponent(historyLabel, historySlider, 1, maxHistory, history,
 		juce::Colour::fromFloatRGBA(0.15f, 0.25f, 0.8f, 1.0f),
 		juce::Colour::fromFloatRGBA(0.15f, 0.5f, 0.8f, 1.0f));
 
-	SetupComponent(volumeLabel, volumeSlider, lookAndFeelVolumeSlider, 0.0, 1.0, volume,
+	SetupComponent(volumeLabel, volumeSlider, 0.0, 1.0, volume,
 		juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 1.0f),
 		juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 1.0f));
 
@@ -73,6 +87,7 @@ Renderer::Renderer(VermeulenLadderFilterAudioProcessor& audioProcessor) : audioP
 	historySlider.onValueChange = [&]
 	{
 		history = static_cast<int>(historySlider.getValue());
+		audioProcessor.setEditorHistory(history);
 	};
 
 	volumeSlider.onValueChange = [&]
@@ -80,20 +95,29 @@ Renderer::Renderer(VermeulenLadderFilterAudioProcessor& audioProcessor) : audioP
 		volume = static_cast<float>(volumeSlider.getValue());
 		audioProcessor.setVolume(volume);
 
-		lookAndFeelVolumeSlider.setColour(juce::Slider::thumbColourId,
+		volumeSlider.setColour(juce::Slider::thumbColourId,
 			juce::Colour::fromFloatRGBA(0.75f, 0.75f, 0.75f, 1.0f));
 
-		lookAndFeelVolumeSlider.setColour(juce::Slider::trackColourId,
+		volumeSlider.setColour(juce::Slider::trackColourId,
 			juce::Colour::fromFloatRGBA(static_cast<float>(1.0 * volume),
 				static_cast<float>(1.0 * (1.0 - volume)),
 				0.0f,
 				1.0f));
-
-		volumeSlider.setLookAndFeel(&lookAndFeelVolumeSlider);
 	};
 
+	addAndMakeVisible(levelMeterDisplay);
 	addAndMakeVisible(modeBox);
 
+	//Readers are started with the segment name, which only ever shows up
+	//in the log otherwise
+	const auto sharedMemoryName = audioProcessor.getSharedMemoryName();
+
+	if (sharedMemoryName.isNotEmpty())
+	{
+		sharedMemoryLabel.setText("Shared memory: " + sharedMemoryName, juce::dontSendNotification);
+		addAndMakeVisible(sharedMemoryLabel);
+	}
+
 	const juce::StringArray list =
 	{ "Low-pass, 12 dB/octave",
 	  "High-pass, 12 dB/octave",
@@ -103,25 +127,92 @@ Renderer::Renderer(VermeulenLadderFilterAudioProcessor& audioProcessor) : audioP
 	  "Band-pass, 24 dB/octave" };
 
 	modeBox.addItemList(list, 1);
-	modeBox.setSelectedId(4);
+	modeBox.setSelectedId(audioProcessor.getMode() + 1);
 
 	modeBox.onChange = [&]
 	{
 		audioProcessor.setMode(modeBox.getSelectedId() - 1);
 	};
 
-	lookAndFeelModeBox.setColour(juce::ComboBox::textColourId, juce::Colour::fromFloatRGBA(0.75f, 0.75f, 0.75f, 1.0f));
-	modeBox.setLookAndFeel(&lookAndFeelModeBox);
+	modeBox.setColour(juce::ComboBox::textColourId, juce::Colour::fromFloatRGBA(0.75f, 0.75f, 0.75f, 1.0f));
+
+	audioProcessor.addChangeListener(this);
 }
 
 Renderer::~Renderer()
 {
+	stopTimer();
+	audioProcessor.removeChangeListener(this);
+}
+
+void Renderer::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+	//Going through the controls keeps their own reactions, such as the
+	//volume colour, in step; pushing the same values back is harmless
+	driveSlider.setValue(audioProcessor.getDrive(), juce::sendNotificationSync);
+	resonanceSlider.setValue(audioProcessor.getResonance(), juce::sendNotificationSync);
+	frequencySlider.setValue(audioProcessor.getCutoffFrequency(), juce::sendNotificationSync);
+	historySlider.setValue(audioProcessor.getEditorHistory(), juce::sendNotificationSync);
+	volumeSlider.setValue(audioProcessor.getVolume(), juce::sendNotificationSync);
+	modeBox.setSelectedId(audioProcessor.getMode() + 1, juce::sendNotificationSync);
+
+	cameraPosition = audioProcessor.getEditorCamera();
+}
+
+bool Renderer::hasRenderedFirstFrame() const
+{
+	return hasRenderedFrame || (softwareWaterfall != nullptr && softwareWaterfall->hasDrawnFrame());
+}
+
+bool Renderer::isUsingSoftwareWaterfall() const
+{
+	return softwareWaterfall != nullptr;
+}
+
+void Renderer::timerCallback()
+{
+	if (hasRenderedFrame)
+	{
+		stopTimer();
+		return;
+	}
+
+	//Hidden time does not count, as the context is only made once showing
+	if (!isShowing())
+	{
+		waitingSince = 0;
+		return;
+	}
 
+	if (waitingSince == 0)
+	{
+		waitingSince = juce::Time::getMillisecondCounter();
+	}
+
+	if (hasGLFailed || juce::Time::getMillisecondCounter() - waitingSince > static_cast<juce::uint32>(glTimeoutMs))
+	{
+		useSoftwareWaterfall();
+	}
+}
+
+void Renderer::useSoftwareWaterfall()
+{
+	stopTimer();
+	context.detach();
+
+	//Sent to the back so the controls along the bottom stay on top of it
+	softwareWaterfall = std::make_unique<SoftwareWaterfall>(audioProcessor);
+	addAndMakeVisible(*softwareWaterfall);
+	softwareWaterfall->toBack();
+
+	resized();
+	repaint();
 }
 
 void Renderer::mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
 {
 	cameraPosition.z -= wheel.deltaY * cameraSpeed;
+	audioProcessor.setEditorCamera(cameraPosition);
 }
 
 void Renderer::mouseDrag(const juce::MouseEvent& event)
@@ -131,23 +222,42 @@ void Renderer::mouseDrag(const juce::MouseEvent& event)
 
 	cameraPosition.x -= deltaX * mouseDragSpeed;
 	cameraPosition.y += deltaY * mouseDragSpeed;
+	audioProcessor.setEditorCamera(cameraPosition);
 }
 
 void Renderer::newOpenGLContextCreated()
 {
 	Buffer::setContext(&context);
 
+	//A context can be created and still be unable to draw the waterfall,
+	//which needs instancing, buffer copies and GLSL 1.50
+	if (juce::OpenGLShaderProgram::getLanguageVersion() < 1.5
+		|| juce::gl::glDrawArraysInstanced == nullptr
+		|| juce::gl::glCopyBufferSubData == nullptr)
+	{
+		hasGLFailed = true;
+		return;
+	}
+
 	shader = std::make_unique<Shader>(context);
 
-	buffer.create(maxVertices);
+	if (!shader->isLinked)
+	{
+		hasGLFailed = true;
+		return;
+	}
 
-	buffer.fillVbo(Buffer::Vbo::vertexBuffer,
-		(GLfloat*) nullptr,
-		maxHistory * maxVertices * static_cast<int> (Buffer::ComponentSize::xy) * sizeof(GLfloat), Buffer::Fill::ongoing);
+	buffer.create(maxVertices);
+	buffer.createStream(maxVertices * static_cast<int> (Buffer::ComponentSize::xy) * sizeof(GLfloat)
+		+ maxVertices * static_cast<int> (Buffer::ComponentSize::rgba) * sizeof(GLfloat));
 
-	buffer.fillVbo(Buffer::Vbo::colourBuffer,
-		(GLfloat*) nullptr,
-		maxHistory * maxVertices * static_cast<int> (Buffer::ComponentSize::rgba) * sizeof(GLfloat), Buffer::Fill::ongoing);
+	//The history buffers get their storage in renderOpenGL, as the ring
+	//reaches each slice. Sizing them for the longest possible history here
+	//would allocate gigabytes before the first frame could be shown
+	startPos = 0;
+	filledSlices = 0;
+	allocatedSlices = 0;
+	ringHistory = history;
 
 	const float farClip = 1000.0f;
 	const float nearClip = 0.1f;
@@ -162,16 +272,15 @@ void Renderer::newOpenGLContextCreated()
 	projectionMatrix.mat[11] = -1.0f;
 	projectionMatrix.mat[14] = -(2.0f * farClip * nearClip) / (farClip - nearClip);
 	projectionMatrix.mat[15] = 0.0f;
-
-	//Build a model matrix to simulate the opposite of a camera movement
-	//We want to move the 'camera' back and up a little
-	cameraPosition.x = 0.0f;
-	cameraPosition.y = 0.15f;
-	cameraPosition.z = 0.25f;
 }
 
 void Renderer::renderOpenGL()
 {
+	if (hasGLFailed)
+	{
+		return;
+	}
+
 	//Build a model matrix to simulate the opposite of a camera movement
 	//We want to move the 'camera' back and up a little
 	modelMatrix.mat[12] = -cameraPosition.x;
@@ -184,12 +293,21 @@ void Renderer::renderOpenGL()
 	shader->model->setMatrix4(modelMatrix.mat, 1, juce::gl::GL_FALSE);
 	shader->projection->setMatrix4(projectionMatrix.mat, 1, juce::gl::GL_FALSE);
 
-	juce::gl::glViewport(0,
-		static_cast<int>(getBounds().getHeight() * 0.17f),
-		getBounds().getWidth(),
-		static_cast<GLsizei>(getBounds().getHeight() * 0.83f));
+	//GL works in physical pixels, which on HiDPI displays are several
+	//times our logical component size
+	const auto renderingScale = static_cast<float>(context.getRenderingScale());
+	const auto viewportWidth = getBounds().getWidth() * renderingScale;
+	const auto viewportHeight = getBounds().getHeight() * renderingScale;
 
-	auto numSamples = audioProcessor.getNumSamples();
+	juce::gl::glViewport(0,
+		static_cast<int>(viewportHeight * 0.17f),
+		static_cast<GLsizei>(viewportWidth),
+		static_cast<GLsizei>(viewportHeight * 0.83f));
+
+	//Each slice has room for maxSampleSize points, so longer host blocks
+	//are drawn from every n-th sample rather than overrunning the buffers
+	const auto numBlockSamples = audioProcessor.getNumSamples();
+	const auto numSamples = juce::jmin(numBlockSamples, maxSampleSize);
 	auto driveNormalized = drive / 100.0f;
 
 	//We are only using left channel data for now
@@ -207,7 +325,7 @@ void Renderer::renderOpenGL()
 	//One 'time slice' of data
 	for (int i = 0; i < numSamples; i++)
 	{
-		auto data = std::abs(channelDataLeft[i]);
+		auto data = std::abs(channelDataLeft[static_cast<juce::int64>(i) * numBlockSamples / numSamples]);
 
 		vertices.push_back(startX + i * 0.001f);   //x
 		vertices.push_back(-0.5f + data);          //y
@@ -221,73 +339,95 @@ void Renderer::renderOpenGL()
 	auto dataSizeVertex = vertices.size() * sizeof(GLfloat);
 	auto dataSizeColor = colors.size() * sizeof(GLfloat);
 
-	static auto startPos = 0;
-	static auto oldHistory = history;
-
-	if (oldHistory < history)
+	//Slices from the ring's previous lap were placed for the old history
+	//size, so the shader would give them the wrong ages. Only the slices
+	//written since the last wrap stay visible; the rest come back as the
+	//ring goes round again
+	if (history != ringHistory)
 	{
-		oldHistory = history;
+		ringHistory = history;
+		filledSlices = juce::jmin(filledSlices, startPos);
 	}
 
-	else if (oldHistory > history)
+	if (startPos >= history)
 	{
-		/*auto d = (oldHistory - history);
-		auto v = d * maxVertices * static_cast<int> (Buffer::ComponentSize::xy) * sizeof(GLfloat);
-		auto c = d * maxVertices * static_cast<int> (Buffer::ComponentSize::rgba) * sizeof(GLfloat);
-
-		buffer.appendVbo(Buffer::Vbo::vertexBuffer, (GLfloat*)nullptr, v, history * dataSizeVertex);
-		buffer.appendVbo(Buffer::Vbo::colourBuffer, (GLfloat*)nullptr, c, history * dataSizeColor);*/
-
-		buffer.fillVbo(Buffer::Vbo::vertexBuffer,
-			(GLfloat*) nullptr,
-			maxHistory * maxVertices * static_cast<int> (Buffer::ComponentSize::xy) * sizeof(GLfloat), Buffer::Fill::ongoing);
-
-		buffer.fillVbo(Buffer::Vbo::colourBuffer,
-			(GLfloat*) nullptr,
-			maxHistory * maxVertices * static_cast<int> (Buffer::ComponentSize::rgba) * sizeof(GLfloat), Buffer::Fill::ongoing);
-
-		oldHistory = history;
+		startPos = 0;
 	}
 
-	if (startPos >= history)
+	if (startPos >= allocatedSlices)
 	{
-		startPos = 0;
+		growHistory(juce::jmin(history, juce::jmax(allocatedSlices * 2, minAllocatedSlices)));
 	}
 
-	buffer.appendVbo(Buffer::Vbo::vertexBuffer, vertices.data(), dataSizeVertex, startPos * dataSizeVertex);
-	buffer.appendVbo(Buffer::Vbo::colourBuffer, colors.data(), dataSizeColor, startPos * dataSizeColor);
+	//Until the ring has gone all the way round, only the slices written so
+	//far are drawn, with the ring size in the shader following them
+	filledSlices = juce::jmin(juce::jmax(filledSlices, startPos + 1), history);
 
-	//RENDER=================================================================================
+	buffer.streamVbo(Buffer::Vbo::vertexBuffer, vertices.data(), dataSizeVertex, startPos * dataSizeVertex);
+	buffer.streamVbo(Buffer::Vbo::colourBuffer, colors.data(), dataSizeColor, startPos * dataSizeColor);
 
-	auto zPos = 0.0f;
-	auto renderStart = startPos;
+	//RENDER=================================================================================
 
 	Buffer::setGLStates();
-	Buffer::setLineWidth(static_cast<GLfloat>(1.0f + (3.0f * driveNormalized)));
 
-	for (int i = 0; i < history; i++)
+	//Every slice of the history is drawn in a single instanced call, one
+	//instance per line segment. Attribute B reads the same buffers as A,
+	//offset by one vertex, so each instance sees both ends of its segment
+	if (numSamples > 1)
 	{
-		shader->zPos->set(zPos);
+		shader->history->set(filledSlices);
+		shader->newestSlice->set(startPos);
+		shader->sliceSpacing->set(0.5f);
+		shader->samplesPerSlice->set(numSamples);
+		shader->lineWidth->set((1.0f + (3.0f * driveNormalized)) * renderingScale);
+		shader->viewportSize->set(static_cast<GLfloat>(viewportWidth),
+			static_cast<GLfloat>(viewportHeight * 0.83f));
+
+		const auto vertexStride = static_cast<GLsizeiptr>(Buffer::ComponentSize::xy) * sizeof(GLfloat);
+		const auto colourStride = static_cast<GLsizeiptr>(Buffer::ComponentSize::rgba) * sizeof(GLfloat);
+
+		buffer.linkVbo(shader->pointA->attributeID, Buffer::vertexBuffer, Buffer::ComponentSize::xy, Buffer::DataType::floatingPoint, 0, 1);
+		buffer.linkVbo(shader->pointB->attributeID, Buffer::vertexBuffer, Buffer::ComponentSize::xy, Buffer::DataType::floatingPoint, vertexStride, 1);
+		buffer.linkVbo(shader->colourA->attributeID, Buffer::colourBuffer, Buffer::ComponentSize::rgba, Buffer::DataType::floatingPoint, 0, 1);
+		buffer.linkVbo(shader->colourB->attributeID, Buffer::colourBuffer, Buffer::ComponentSize::rgba, Buffer::DataType::floatingPoint, colourStride, 1);
+		buffer.renderInstanced(Buffer::RenderMode::triangleStrip, 4, filledSlices * numSamples - 1);
+	}
 
-		buffer.linkVbo(shader->vertexIn->attributeID, Buffer::vertexBuffer, Buffer::ComponentSize::xy, Buffer::DataType::floatingPoint);
-		buffer.linkVbo(shader->colourIn->attributeID, Buffer::colourBuffer, Buffer::ComponentSize::rgba, Buffer::DataType::floatingPoint);
-		buffer.render(Buffer::RenderMode::lineStrip, renderStart * numSamples, numSamples);
+	buffer.endStreamFrame();
+	startPos++;
 
-		zPos -= 0.5f;
-		renderStart -= 1;
+	hasRenderedFrame = true;
+}
 
-		if (renderStart < 0)
-		{
-			renderStart = history - 1;
-		}
-	}
+void Renderer::growHistory(int numSlices)
+{
+	//Each slice has room for the largest block, whatever the host sends now
+	const auto vertexSliceSize = static_cast<GLsizeiptr>(maxVertices) * static_cast<int> (Buffer::ComponentSize::xy) * sizeof(GLfloat);
+	const auto colourSliceSize = static_cast<GLsizeiptr>(maxVertices) * static_cast<int> (Buffer::ComponentSize::rgba) * sizeof(GLfloat);
 
-	startPos++;
+	buffer.resizeVbo(Buffer::Vbo::vertexBuffer, allocatedSlices * vertexSliceSize, numSlices * vertexSliceSize, Buffer::Fill::ongoing);
+	buffer.resizeVbo(Buffer::Vbo::colourBuffer, allocatedSlices * colourSliceSize, numSlices * colourSliceSize, Buffer::Fill::ongoing);
+
+	allocatedSlices = numSlices;
 }
 
 void Renderer::openGLContextClosing()
 {
-	buffer.destroy();
+	if (!hasGLFailed)
+	{
+		buffer.destroy();
+	}
+
+	allocatedSlices = 0;
+}
+
+void Renderer::paint(juce::Graphics& graphics)
+{
+	//With OpenGL the background is cleared in renderOpenGL instead
+	if (softwareWaterfall != nullptr)
+	{
+		graphics.fillAll(juce::Colour(23, 24, 23));
+	}
 }
 
 void Renderer::resized()
@@ -295,9 +435,17 @@ void Renderer::resized()
 	auto bounds = getBounds();
 	auto heightScale = bounds.getHeight() / static_cast<float>(startHeight);
 
+	//The same area as the GL viewport, above the controls
+	if (softwareWaterfall != nullptr)
+	{
+		softwareWaterfall->setBounds(0, 0, bounds.getWidth(), static_cast<int>(bounds.getHeight() * 0.83f));
+	}
+
 	modeBox.setBounds(static_cast<int>(bounds.getWidth() * 0.05f),
 		static_cast<int>(bounds.getHeight() * 0.88f), 175, 30);
 
+	sharedMemoryLabel.setBounds(modeBox.getX(), modeBox.getBottom() + 2, 300, 20);
+
 	auto SetBounds = [&heightScale, &bounds](juce::Slider& slider, juce::Label& label, float x, int sliderWidth)
 	{
 		slider.setBounds(static_cast<int>(x),
@@ -316,4 +464,10 @@ void Renderer::resized()
 	SetBounds(frequencySlider, frequencyLabel, bounds.getWidth() * 0.5f, 100);
 	SetBounds(historySlider, historyLabel, bounds.getWidth() * 0.625f, 100);
 	SetBounds(volumeSlider, volumeLabel, bounds.getWidth() * 0.8f, 175);
+
+	//The meter sits just right of the volume slider, sharing its label row
+	levelMeterDisplay.setBounds(static_cast<int>(bounds.getWidth() * 0.8f) + 180,
+		static_cast<int>(bounds.getHeight() * 0.83f),
+		40,
+		static_cast<int>(bounds.getHeight() * 0.15f));
 }
\ No newline at end of file
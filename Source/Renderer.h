@@ -8,16 +8,19 @@
 #include "Shader.h"
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "LevelMeterDisplay.h"
+#include "SoftwareWaterfall.h"
 
 const int maxSampleSize{ 2048 };
 
-class Renderer : public juce::Component, public juce::OpenGLRenderer
+class Renderer : public juce::Component, public juce::OpenGLRenderer, public juce::ChangeListener,
+	private juce::Timer
 {
 
 public:
 
-	const int startWidth = 1280;
-	const int startHeight = 720;
+	static const int startWidth{ 1280 };
+	static const int startHeight{ 720 };
 
 	Renderer(VermeulenLadderFilterAudioProcessor& audioProcessor);
 	~Renderer();
@@ -30,14 +33,39 @@ public:
 	void newOpenGLContextCreated() override;
 	void renderOpenGL() override;
 	void openGLContextClosing() override;
+	void paint(juce::Graphics& graphics) override;
 	void resized() override;
 
+	//Called when the processor has restored a saved state
+	void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+	//True once the waterfall has been drawn at least once
+	bool hasRenderedFirstFrame() const;
+
+	//True when the waterfall is drawn on the CPU instead of through OpenGL
+	bool isUsingSoftwareWaterfall() const;
+
 private:
 
+	void timerCallback() override;
+	void growHistory(int numSlices);
+	void useSoftwareWaterfall();
+
 	const int maxChannels{ 1 };
 	const int maxHistory{ 100000 };
 	const int maxVertices{ maxSampleSize * maxChannels };
 
+	//The history buffers start with room for this many slices and double
+	//as the ring first fills them, up to the history currently shown
+	const int minAllocatedSlices{ 64 };
+
+	//How long a showing renderer waits for its first GL frame before it
+	//gives up on OpenGL, for drivers that fail without saying so
+	const int glTimeoutMs{ 3000 };
+
+	//Set to anything to skip OpenGL and always draw on the CPU
+	const char* softwareWaterfallVariable{ "VERMEULEN_SOFTWARE_WATERFALL" };
+
 	VermeulenLadderFilterAudioProcessor& audioProcessor;
 
 	int history{ 50 };
@@ -48,40 +76,46 @@ private:
 	float frequency{ 44100.0 };
 	float mouseDragSpeed{ 0.5f };
 
+	int startPos{ 0 };
+	int filledSlices{ 0 };
+	int ringHistory{ 0 };
+	int allocatedSlices{ 0 };
+	std::atomic<bool> hasRenderedFrame{ false };
+	std::atomic<bool> hasGLFailed{ false };
+	juce::uint32 waitingSince{ 0 };
+
 	Buffer buffer;
 	juce::OpenGLContext context;
 	std::unique_ptr<Shader> shader;
+	std::unique_ptr<SoftwareWaterfall> softwareWaterfall;
 
 	juce::Vector3D<GLfloat> cameraPosition{ 0.0f, 0.0f, 0.0f };
 
 	juce::Matrix3D<GLfloat> modelMatrix;
 	juce::Matrix3D<GLfloat> projectionMatrix;
 
-	juce::LookAndFeel_V4 lookAndFeelModeBox;
 	juce::ComboBox modeBox{ "ModeBox" };
+	juce::Label sharedMemoryLabel{ "SharedMemoryLabel" };
 
-	juce::LookAndFeel_V4 lookAndFeelDriveSlider;
 	juce::Label driveLabel{ "DriveLabel", "Drive" };
 	juce::Slider driveSlider{ juce::Slider::SliderStyle::RotaryHorizontalDrag,
 		juce::Slider::TextEntryBoxPosition::TextBoxBelow };
 
-	juce::LookAndFeel_V4 lookAndFeelResonanceSlider;
 	juce::Label resonanceLabel{ "ResonanceLabel", "Resonance" };
 	juce::Slider resonanceSlider{ juce::Slider::SliderStyle::RotaryHorizontalDrag,
 		juce::Slider::TextEntryBoxPosition::TextBoxBelow };
 
-	juce::LookAndFeel_V4 lookAndFeelFrequencySlider;
 	juce::Label frequencyLabel{ "FrequencyLabel", "Frequency" };
 	juce::Slider frequencySlider{ juce::Slider::SliderStyle::RotaryHorizontalDrag,
 		juce::Slider::TextEntryBoxPosition::TextBoxBelow };
 
-	juce::LookAndFeel_V4 lookAndFeelHistorySlider;
 	juce::Label historyLabel{ "HistoryLabel", "History" };
 	juce::Slider historySlider{ juce::Slider::SliderStyle::RotaryHorizontalDrag,
 		juce::Slider::TextEntryBoxPosition::TextBoxBelow };
 
-	juce::LookAndFeel_V4 lookAndFeelVolumeSlider;
 	juce::Label volumeLabel{ "VolumeLabel", "Volume" };
 	juce::Slider volumeSlider{ juce::Slider::SliderStyle::LinearHorizontal,
 		juce::Slider::TextEntryBoxPosition::TextBoxBelow };
+
+	LevelMeterDisplay levelMeterDisplay{ audioProcessor.getLevelMeter() };
 };
\ No newline at end of file
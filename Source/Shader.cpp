@@ -39,10 +39,22 @@ Shader::Shader(juce::OpenGLContext& glContext) : juce::OpenGLShaderProgram(glCon
 		jassertfalse;
 	}
 
-	vertexIn = std::make_unique<Attribute>(*this, "vertexIn");
-	colourIn = std::make_unique<Attribute>(*this, "colourIn");
+	else
+	{
+		isLinked = true;
+	}
+
+	pointA = std::make_unique<Attribute>(*this, "pointA");
+	pointB = std::make_unique<Attribute>(*this, "pointB");
+	colourA = std::make_unique<Attribute>(*this, "colourA");
+	colourB = std::make_unique<Attribute>(*this, "colourB");
 	
-	zPos = std::make_unique<Uniform>(*this, "zPos");
 	model = std::make_unique<Uniform>(*this, "model");
+	history = std::make_unique<Uniform>(*this, "history");
+	lineWidth = std::make_unique<Uniform>(*this, "lineWidth");
 	projection = std::make_unique<Uniform>(*this, "projection");
+	newestSlice = std::make_unique<Uniform>(*this, "newestSlice");
+	sliceSpacing = std::make_unique<Uniform>(*this, "sliceSpacing");
+	viewportSize = std::make_unique<Uniform>(*this, "viewportSize");
+	samplesPerSlice = std::make_unique<Uniform>(*this, "samplesPerSlice");
 }
\ No newline at end of file
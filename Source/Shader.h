@@ -12,10 +12,20 @@ public:
 
 	Shader(juce::OpenGLContext& glContext);
 
-	std::unique_ptr<Attribute> vertexIn;
-	std::unique_ptr<Attribute> colourIn;
+	//False if the driver failed to compile or link the shaders
+	bool isLinked{ false };
+
+	std::unique_ptr<Attribute> pointA;
+	std::unique_ptr<Attribute> pointB;
+	std::unique_ptr<Attribute> colourA;
+	std::unique_ptr<Attribute> colourB;
 	
-	std::unique_ptr<Uniform> zPos;
 	std::unique_ptr<Uniform> model;
+	std::unique_ptr<Uniform> history;
+	std::unique_ptr<Uniform> lineWidth;
 	std::unique_ptr<Uniform> projection;
+	std::unique_ptr<Uniform> newestSlice;
+	std::unique_ptr<Uniform> sliceSpacing;
+	std::unique_ptr<Uniform> viewportSize;
+	std::unique_ptr<Uniform> samplesPerSlice;
 };
\ No newline at end of file
@@ -1,7 +1,12 @@
 in vec4 colourOut;
+in float edgeDistance;
 out vec4 fragColour;
 
+uniform float lineWidth;
+
 void main (void)
 {
-    fragColour = colourOut;
+    //Analytic coverage: full inside the line, fading to zero over the last pixel
+    float coverage = clamp(lineWidth * 0.5 + 0.5 - abs(edgeDistance), 0.0, 1.0);
+    fragColour = vec4(colourOut.rgb, colourOut.a * coverage);
 }
\ No newline at end of file
@@ -1,13 +1,50 @@
-in vec2 vertexIn;
-in vec4 colourIn;
+in vec2 pointA;
+in vec2 pointB;
+in vec4 colourA;
+in vec4 colourB;
 out vec4 colourOut;
+out float edgeDistance;
 
-uniform float zPos;
 uniform mat4 model;
 uniform mat4 projection;
+uniform vec2 viewportSize;
+uniform float lineWidth;
+uniform float sliceSpacing;
+uniform int history;
+uniform int newestSlice;
+uniform int samplesPerSlice;
 
+//Each instance is one line segment from pointA to pointB, drawn as a
+//four-vertex triangle strip that is extruded sideways in screen space
 void main()
 {
-    colourOut = colourIn;
-    gl_Position = projection * model * vec4(vertexIn, zPos, 1.0);
+    int slice = gl_InstanceID / samplesPerSlice;
+    int age = (newestSlice - slice + history) % history;
+    float zPos = -sliceSpacing * float(age);
+
+    vec4 clipA = projection * model * vec4(pointA, zPos, 1.0);
+    vec4 clipB = projection * model * vec4(pointB, zPos, 1.0);
+
+    vec2 screenA = clipA.xy / clipA.w * 0.5 * viewportSize;
+    vec2 screenB = clipB.xy / clipB.w * 0.5 * viewportSize;
+    vec2 direction = screenB - screenA;
+    direction = (length(direction) > 0.0) ? normalize(direction) : vec2(1.0, 0.0);
+    vec2 normal = vec2(-direction.y, direction.x);
+
+    bool isEndB = gl_VertexID >= 2;
+    float side = (gl_VertexID % 2 == 0) ? -1.0 : 1.0;
+
+    //Pad by a pixel on each side so the fragment shader has room to fade the edge
+    float halfWidth = lineWidth * 0.5 + 1.0;
+
+    vec4 clip = isEndB ? clipB : clipA;
+    clip.xy += normal * side * halfWidth * 2.0 / viewportSize * clip.w;
+
+    colourOut = isEndB ? colourB : colourA;
+    edgeDistance = side * halfWidth;
+
+    //The segment joining the last sample of one slice to the first sample
+    //of the next is collapsed to nothing
+    bool isSliceEnd = (gl_InstanceID % samplesPerSlice) == samplesPerSlice - 1;
+    gl_Position = isSliceEnd ? vec4(0.0, 0.0, 0.0, 1.0) : clip;
 }
\ No newline at end of file
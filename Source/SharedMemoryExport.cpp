@@ -0,0 +1,216 @@
+#include "SharedMemoryExport.h"
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//Another process only sees the same values if the atomics are plain memory
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared counters must be lock-free");
+static_assert(sizeof(std::atomic<float>) == sizeof(float), "Shared meters must be plain floats");
+
+SharedMemoryExport::SharedMemoryExport(const juce::String& name, int numChannels, double sampleRate)
+	: name(name),
+	numChannels(juce::jlimit(1, static_cast<int>(SharedMemoryLayout::maxChannels), numChannels))
+{
+	const auto totalSize = SharedMemoryLayout::getTotalSize();
+
+#if JUCE_WINDOWS
+	mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(static_cast<juce::uint64>(totalSize) >> 32),
+		static_cast<DWORD>(totalSize & 0xffffffff), name.toWideCharPointer());
+
+	//A named mapping goes away with its last handle, so one that already
+	//exists belongs to a live process and is never written into
+	if (mapping != nullptr && GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		juce::Logger::writeToLog("Shared memory segment " + name + " is already in use by another process");
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+
+	if (mapping != nullptr)
+	{
+		memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, totalSize);
+	}
+#else
+	fileDescriptor = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+
+	//POSIX segments outlive a process that crashed, so one that already
+	//exists is usually stale. It is taken over by unlinking it and creating
+	//a fresh one: anything still mapping the old segment keeps it, and two
+	//writers never end up sharing, or resizing, one segment
+	if (fileDescriptor < 0 && errno == EEXIST)
+	{
+		juce::Logger::writeToLog("Taking over existing shared memory segment " + name);
+		shm_unlink(name.toRawUTF8());
+		fileDescriptor = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	}
+
+	if (fileDescriptor >= 0 && ftruncate(fileDescriptor, static_cast<off_t>(totalSize)) == 0)
+	{
+		memory = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+
+		if (memory == MAP_FAILED)
+		{
+			memory = nullptr;
+		}
+	}
+#endif
+
+	if (memory == nullptr)
+	{
+		juce::Logger::writeToLog("Could not create shared memory segment " + name);
+		return;
+	}
+
+	auto* bytes = static_cast<char*>(memory);
+	header = new (bytes) SharedMemoryLayout::Header();
+	audio = reinterpret_cast<float*>(bytes + SharedMemoryLayout::getAudioOffset());
+	analysis = reinterpret_cast<SharedMemoryLayout::AnalysisFrame*>(bytes + SharedMemoryLayout::getAnalysisOffset());
+
+	header->numChannels = static_cast<std::uint32_t>(this->numChannels);
+	header->audioCapacity = SharedMemoryLayout::audioCapacity;
+	header->analysisCapacity = SharedMemoryLayout::analysisCapacity;
+	header->sampleRate = sampleRate;
+	header->audioWritePosition.store(0);
+	header->analysisWriteCount.store(0);
+
+	for (std::uint32_t channel = 0; channel < SharedMemoryLayout::maxChannels; ++channel)
+	{
+		header->peak[channel].store(0.0f);
+		header->rms[channel].store(0.0f);
+	}
+
+	header->version = SharedMemoryLayout::version;
+
+	//Readers check the magic last, so everything above is in place once it shows up
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = SharedMemoryLayout::magic;
+
+	juce::Logger::writeToLog("Publishing to shared memory segment " + name);
+}
+
+SharedMemoryExport::~SharedMemoryExport()
+{
+	const auto totalSize = SharedMemoryLayout::getTotalSize();
+
+#if JUCE_WINDOWS
+	if (memory != nullptr)
+	{
+		UnmapViewOfFile(memory);
+	}
+
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+	}
+#else
+	if (memory != nullptr)
+	{
+		munmap(memory, totalSize);
+	}
+
+	if (fileDescriptor >= 0)
+	{
+		close(fileDescriptor);
+		shm_unlink(name.toRawUTF8());
+	}
+#endif
+}
+
+juce::String SharedMemoryExport::createName(const juce::String& requestedName)
+{
+	static std::atomic<int> instanceCount{ 0 };
+	const auto instance = instanceCount++;
+
+#if JUCE_WINDOWS
+	const auto processId = static_cast<int>(GetCurrentProcessId());
+	const juce::String prefix("Local\\");
+#else
+	const auto processId = static_cast<int>(getpid());
+	const juce::String prefix("/");
+#endif
+
+	if (requestedName.isEmpty() || requestedName == "1")
+	{
+		return prefix + "VermeulenLadderFilter-" + juce::String(processId) + "-" + juce::String(instance);
+	}
+
+	//Segment names may not contain further path separators
+	const auto legalName = juce::File::createLegalFileName(requestedName);
+
+	return prefix + (instance == 0 ? legalName : legalName + "-" + juce::String(instance));
+}
+
+bool SharedMemoryExport::isOpen() const
+{
+	return header != nullptr;
+}
+
+const juce::String& SharedMemoryExport::getName() const
+{
+	return name;
+}
+
+int SharedMemoryExport::getNumChannels() const
+{
+	return numChannels;
+}
+
+void SharedMemoryExport::setSampleRate(double sampleRate)
+{
+	if (header != nullptr)
+	{
+		header->sampleRate = sampleRate;
+	}
+}
+
+void SharedMemoryExport::publish(const juce::AudioBuffer<float>& buffer, SharedMemoryLayout::AnalysisFrame& frame)
+{
+	if (header == nullptr)
+	{
+		return;
+	}
+
+	const auto channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+	for (int channel = 0; channel < channels; ++channel)
+	{
+		header->peak[channel].store(frame.peak[channel], std::memory_order_relaxed);
+		header->rms[channel].store(frame.rms[channel], std::memory_order_relaxed);
+	}
+
+	//Readers rely on no more than maxBlockSize samples landing between two
+	//position updates, so longer host blocks go out in several pieces, each
+	//with its own analysis frame
+	for (int offset = 0; offset < buffer.getNumSamples(); offset += static_cast<int>(SharedMemoryLayout::maxBlockSize))
+	{
+		const auto numSamples = juce::jmin(buffer.getNumSamples() - offset, static_cast<int>(SharedMemoryLayout::maxBlockSize));
+		const auto start = static_cast<int>(audioWritePosition % SharedMemoryLayout::audioCapacity);
+		const auto firstPart = juce::jmin(numSamples, static_cast<int>(SharedMemoryLayout::audioCapacity) - start);
+
+		for (int channel = 0; channel < channels; ++channel)
+		{
+			auto* ring = audio + static_cast<size_t>(channel) * SharedMemoryLayout::audioCapacity;
+			const auto* data = buffer.getReadPointer(channel, offset);
+
+			std::memcpy(ring + start, data, sizeof(float) * static_cast<size_t>(firstPart));
+			std::memcpy(ring, data + firstPart, sizeof(float) * static_cast<size_t>(numSamples - firstPart));
+		}
+
+		frame.samplePosition = audioWritePosition;
+		frame.numSamples = static_cast<std::uint32_t>(numSamples);
+		analysis[analysisWriteCount % SharedMemoryLayout::analysisCapacity] = frame;
+
+		audioWritePosition += static_cast<std::uint64_t>(numSamples);
+		analysisWriteCount++;
+
+		header->audioWritePosition.store(audioWritePosition, std::memory_order_release);
+		header->analysisWriteCount.store(analysisWriteCount, std::memory_order_release);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedMemoryLayout.h"
+
+//Publishes post-filter audio, meters and per-block analysis frames into a
+//named shared-memory segment laid out as described in SharedMemoryLayout.h.
+//The segment is created and removed on the message thread; publish() is
+//the only call made from the audio thread and never blocks or allocates
+class SharedMemoryExport
+{
+public:
+
+	//An existing segment of the same name is taken over on POSIX systems,
+	//where it may be left from a crash, and left alone on Windows, where it
+	//can only belong to a live process. isOpen() tells whether it worked
+	SharedMemoryExport(const juce::String& name, int numChannels, double sampleRate);
+	~SharedMemoryExport();
+
+	//The segment name for an export requested with the given value of
+	//VERMEULEN_SHARED_MEMORY. "1" gives a name built from the process ID;
+	//anything else is used as the name itself. Every call after the first
+	//in a process appends a count, so instances never share a segment
+	static juce::String createName(const juce::String& requestedName);
+
+	bool isOpen() const;
+	const juce::String& getName() const;
+	int getNumChannels() const;
+
+	//Lets a re-prepared processor keep its segment, and the readers
+	//mapping it, when only the sample rate changed
+	void setSampleRate(double sampleRate);
+
+	void publish(const juce::AudioBuffer<float>& buffer, SharedMemoryLayout::AnalysisFrame& frame);
+
+private:
+
+	juce::String name;
+
+	void* memory{ nullptr };
+	SharedMemoryLayout::Header* header{ nullptr };
+	float* audio{ nullptr };
+	SharedMemoryLayout::AnalysisFrame* analysis{ nullptr };
+
+	int numChannels{ 0 };
+	std::uint64_t audioWritePosition{ 0 };
+	std::uint64_t analysisWriteCount{ 0 };
+
+#if JUCE_WINDOWS
+	void* mapping{ nullptr };
+#else
+	int fileDescriptor{ -1 };
+#endif
+
+	JUCE_DECLARE_NON_COPYABLE(SharedMemoryExport)
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//Layout of the shared-memory segment a processor publishes into when its
+//export is enabled. This header has no JUCE dependency so that external
+//readers can include it on its own.
+//
+//  [Header][audio: numChannels x audioCapacity floats][analysis: analysisCapacity frames]
+//
+//There is a single writer, the audio thread, and any number of readers.
+//Neither side ever waits for the other:
+//
+//- Audio is planar, one channel after another, and sample n of a channel
+//  lives at index n % audioCapacity. The writer copies a block in and then
+//  publishes it with a release store of the new total to audioWritePosition.
+//  A reader acquire-loads audioWritePosition, reads backwards from it, and
+//  loads it again afterwards. Sample n is intact if that second load is
+//  below n + audioCapacity - maxBlockSize, so staying within the newest half
+//  of the ring is always safe.
+//
+//- Analysis frames work the same way through analysisWriteCount, with one
+//  frame written per processed block. Frame i is intact if the count read
+//  after copying it is below i + analysisCapacity.
+//
+//- The meters always hold the latest per-channel levels and can be read at
+//  any time.
+struct SharedMemoryLayout
+{
+	static const std::uint32_t magic{ 0x53464c56 };
+	static const std::uint32_t version{ 1 };
+	static const std::uint32_t maxChannels{ 2 };
+	static const std::uint32_t maxBlockSize{ 8192 };
+	static const std::uint32_t audioCapacity{ 1 << 16 };
+	static const std::uint32_t analysisCapacity{ 512 };
+
+	struct AnalysisFrame
+	{
+		std::uint64_t samplePosition;
+		std::uint32_t numSamples;
+		std::int32_t mode;
+		std::int32_t isSleeping;
+		float drive;
+		float volume;
+		float resonance;
+		float cutoffFrequency;
+		float peak[maxChannels];
+		float rms[maxChannels];
+	};
+
+	struct Header
+	{
+		std::uint32_t magic;
+		std::uint32_t version;
+		std::uint32_t numChannels;
+		std::uint32_t audioCapacity;
+		std::uint32_t analysisCapacity;
+		std::uint32_t reserved;
+		double sampleRate;
+
+		std::atomic<std::uint64_t> audioWritePosition;
+		std::atomic<std::uint64_t> analysisWriteCount;
+
+		std::atomic<float> peak[maxChannels];
+		std::atomic<float> rms[maxChannels];
+	};
+
+	static std::size_t getAudioOffset()
+	{
+		//Keep the sample data on its own cache lines
+		return (sizeof(Header) + 63) & ~static_cast<std::size_t>(63);
+	}
+
+	static std::size_t getAnalysisOffset()
+	{
+		return getAudioOffset() + sizeof(float) * maxChannels * audioCapacity;
+	}
+
+	static std::size_t getTotalSize()
+	{
+		return getAnalysisOffset() + sizeof(AnalysisFrame) * analysisCapacity;
+	}
+};
\ No newline at end of file
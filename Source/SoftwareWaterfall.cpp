@@ -0,0 +1,199 @@
+#include "SoftwareWaterfall.h"
+
+SoftwareWaterfall::SoftwareWaterfall(VermeulenLadderFilterAudioProcessor& audioProcessor) : audioProcessor(audioProcessor)
+{
+	setOpaque(true);
+	setInterceptsMouseClicks(false, false);
+	startTimerHz(refreshRate);
+}
+
+SoftwareWaterfall::~SoftwareWaterfall()
+{
+	stopTimer();
+}
+
+bool SoftwareWaterfall::hasDrawnFrame() const
+{
+	return hasDrawn;
+}
+
+void SoftwareWaterfall::resized()
+{
+	createImage();
+}
+
+void SoftwareWaterfall::createImage()
+{
+	//Starting the history again is simpler than rescaling it, and at one
+	//slice per frame it has filled back up within a second or two
+	imageScale = juce::Component::getApproximateScaleFactorForComponent(this);
+
+	const auto width = juce::roundToInt(getWidth() * imageScale);
+	const auto height = juce::roundToInt(getHeight() * imageScale);
+
+	if (width <= 0 || height <= 0)
+	{
+		waterfall = {};
+		return;
+	}
+
+	waterfall = juce::Image(juce::Image::ARGB, width, height, true);
+
+	for (auto* columns : { &peaks, &heights, &tops, &bottoms, &fades, &distances, &coverage })
+	{
+		columns->resize(static_cast<size_t>(width));
+	}
+
+	//Opacity fades towards both ends of the slice, as the GL version does
+	const auto halfColumns = width * 0.5f;
+
+	for (int column = 0; column < width; ++column)
+	{
+		fades[static_cast<size_t>(column)] = 255.0f * juce::jmax(0.0f, 1.0f - std::abs(column / halfColumns - 1.0f));
+	}
+
+	hasSlice = false;
+}
+
+void SoftwareWaterfall::paint(juce::Graphics& graphics)
+{
+	graphics.fillAll(juce::Colour(23, 24, 23));
+
+	if (waterfall.isValid())
+	{
+		graphics.drawImage(waterfall, getLocalBounds().toFloat());
+		hasDrawn = hasDrawn || hasSlice;
+	}
+}
+
+void SoftwareWaterfall::timerCallback()
+{
+	//Moving to a display with another scale makes the image the wrong size
+	if (juce::Component::getApproximateScaleFactorForComponent(this) != imageScale)
+	{
+		createImage();
+	}
+
+	const auto numSamples = audioProcessor.getNumSamples();
+	const auto* data = audioProcessor.getChannelDataLeft();
+
+	if (!waterfall.isValid() || data == nullptr || numSamples < 2)
+	{
+		return;
+	}
+
+	//The whole history fits the height while it can, and beyond that each
+	//slice moves the others up by a single row
+	const auto history = juce::jmax(1, audioProcessor.getEditorHistory());
+	const auto spacing = juce::jmax(1, juce::roundToInt(waterfall.getHeight() / static_cast<float>(history)));
+	const auto visibleSlices = juce::jlimit(1, history, waterfall.getHeight() / spacing);
+	const auto fade = juce::roundToInt(256.0f * std::pow(oldestBrightness, 1.0f / visibleSlices));
+
+	juce::Image::BitmapData pixels(waterfall, juce::Image::BitmapData::readWrite);
+	scroll(pixels, spacing, fade);
+	drawSlice(pixels, data, numSamples);
+
+	hasSlice = true;
+	repaint();
+}
+
+void SoftwareWaterfall::scroll(juce::Image::BitmapData& pixels, int numRows, int fade)
+{
+	const auto rowBytes = static_cast<size_t>(pixels.width * pixels.pixelStride);
+	const auto movedRows = juce::jmax(0, pixels.height - numRows);
+
+	//Moving and fading happen in one pass. Scaling every channel, alpha
+	//included, keeps the premultiplied pixels valid, and the loop has no
+	//dependencies between bytes so the compiler vectorises it
+	for (int y = 0; y < movedRows; ++y)
+	{
+		const auto* source = pixels.getLinePointer(y + numRows);
+		auto* destination = pixels.getLinePointer(y);
+
+		for (size_t i = 0; i < rowBytes; ++i)
+		{
+			destination[i] = static_cast<juce::uint8>((source[i] * fade + 128) >> 8);
+		}
+	}
+
+	for (int y = movedRows; y < pixels.height; ++y)
+	{
+		std::memset(pixels.getLinePointer(y), 0, rowBytes);
+	}
+}
+
+void SoftwareWaterfall::drawSlice(juce::Image::BitmapData& pixels, const float* data, int numSamples)
+{
+	const auto width = pixels.width;
+	const auto height = pixels.height;
+
+	//Colour and thickness follow the same settings as in the GL shader
+	const auto driveNormalized = audioProcessor.getDrive() / 100.0f;
+	const auto resonance = audioProcessor.getResonance();
+	const auto halfLineWidth = 0.5f * (1.0f + 3.0f * driveNormalized) * imageScale;
+	const auto green = static_cast<juce::uint32>(juce::roundToInt(255.0f * juce::jlimit(0.0f, 1.0f, 0.57f - resonance - driveNormalized)));
+	const auto blue = static_cast<juce::uint32>(juce::roundToInt(255.0f * juce::jlimit(0.0f, 1.0f, 1.0f - driveNormalized)));
+
+	//The loudest sample that lands in each column, so that short peaks are
+	//not lost when there are more samples than columns
+	for (int column = 0; column < width; ++column)
+	{
+		const auto first = column * numSamples / width;
+		const auto last = juce::jmax(first + 1, (column + 1) * numSamples / width);
+		const auto range = juce::FloatVectorOperations::findMinAndMax(data + first, last - first);
+		peaks[static_cast<size_t>(column)] = juce::jmax(-range.getStart(), range.getEnd());
+	}
+
+	//Peaks rise from a baseline along the bottom edge
+	const auto baseline = height - 1.0f - halfLineWidth;
+	juce::FloatVectorOperations::multiply(heights.data(), peaks.data(), -0.25f * height, width);
+	juce::FloatVectorOperations::add(heights.data(), baseline, width);
+
+	//The polyline only ever moves one column at a time, so each segment is
+	//a vertical span in its column from the lower to the higher of its two
+	//ends, padded by half the line width
+	juce::FloatVectorOperations::min(tops.data(), heights.data(), heights.data() + 1, width - 1);
+	juce::FloatVectorOperations::max(bottoms.data(), heights.data(), heights.data() + 1, width - 1);
+	tops.back() = heights.back();
+	bottoms.back() = heights.back();
+	juce::FloatVectorOperations::add(tops.data(), -halfLineWidth, width);
+	juce::FloatVectorOperations::add(bottoms.data(), halfLineWidth, width);
+
+	const auto firstRow = juce::jmax(0, static_cast<int>(std::floor(juce::FloatVectorOperations::findMinimum(tops.data(), width))));
+	const auto lastRow = juce::jmin(height - 1, static_cast<int>(std::ceil(juce::FloatVectorOperations::findMaximum(bottoms.data(), width))));
+
+	//Within a column the coverage only depends on the row, so the spans are
+	//filled a whole row at a time, which keeps every step a straight pass
+	//over contiguous memory that vectorises
+	for (int row = firstRow; row <= lastRow; ++row)
+	{
+		//Full inside the span, fading to nothing over its last pixel:
+		//min(centre - top, bottom - centre) + 0.5, within 0 to 1
+		const auto centre = row + 0.5f;
+		juce::FloatVectorOperations::negate(coverage.data(), tops.data(), width);
+		juce::FloatVectorOperations::add(coverage.data(), centre + 0.5f, width);
+		juce::FloatVectorOperations::add(distances.data(), bottoms.data(), 0.5f - centre, width);
+		juce::FloatVectorOperations::min(coverage.data(), coverage.data(), distances.data(), width);
+		juce::FloatVectorOperations::clip(coverage.data(), coverage.data(), 0.0f, 1.0f, width);
+		juce::FloatVectorOperations::multiply(coverage.data(), fades.data(), width);
+
+		//The same premultiplied source-over as PixelARGB::blend, working on
+		//two channels at a time. A transparent source leaves the pixel as
+		//it is, so columns outside their span need no branch
+		auto* line = reinterpret_cast<juce::uint32*>(pixels.getLinePointer(row));
+
+		for (int column = 0; column < width; ++column)
+		{
+			const auto opacity = static_cast<juce::uint32>(coverage[static_cast<size_t>(column)] + 0.5f);
+			const auto inverse = 256 - opacity;
+			const auto pixel = line[column];
+
+			const auto sourceEven = (blue * opacity * 0x8081) >> 23;
+			const auto sourceOdd = (opacity << 16) | ((green * opacity * 0x8081) >> 23);
+			const auto even = sourceEven + ((((pixel & 0x00ff00ff) * inverse) >> 8) & 0x00ff00ff);
+			const auto odd = sourceOdd + (((((pixel >> 8) & 0x00ff00ff) * inverse) >> 8) & 0x00ff00ff);
+
+			line[column] = (even & 0x00ff00ff) | ((odd & 0x00ff00ff) << 8);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//The waterfall drawn on the CPU into an image, for machines where OpenGL
+//is missing or too old, such as remote desktops and virtual machines.
+//
+//Rather than redrawing every slice of the history, each frame moves the
+//previous image up by one slice spacing, fading it as it goes, and then
+//rasterises only the newest slice along the bottom. The cost per frame is
+//one pass over the image whatever the history length
+class SoftwareWaterfall : public juce::Component, private juce::Timer
+{
+public:
+
+	SoftwareWaterfall(VermeulenLadderFilterAudioProcessor& audioProcessor);
+	~SoftwareWaterfall() override;
+
+	void paint(juce::Graphics& graphics) override;
+	void resized() override;
+
+	//True once at least one slice has been drawn and shown
+	bool hasDrawnFrame() const;
+
+private:
+
+	void timerCallback() override;
+	void createImage();
+	void scroll(juce::Image::BitmapData& pixels, int numRows, int fade);
+	void drawSlice(juce::Image::BitmapData& pixels, const float* data, int numSamples);
+
+	const int refreshRate{ 60 };
+
+	//Slices older than the history are faded to this fraction of their
+	//brightness by the time they would have left the waterfall
+	const float oldestBrightness{ 0.1f };
+
+	VermeulenLadderFilterAudioProcessor& audioProcessor;
+
+	//The image has one pixel per physical pixel, so it stays sharp on
+	//HiDPI displays, and is made again when the display scale changes
+	juce::Image waterfall;
+	float imageScale{ 1.0f };
+
+	std::vector<float> peaks;
+	std::vector<float> heights;
+	std::vector<float> tops;
+	std::vector<float> bottoms;
+	std::vector<float> fades;
+	std::vector<float> distances;
+	std::vector<float> coverage;
+	bool hasSlice{ false };
+	bool hasDrawn{ false };
+};
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <JuceHeader.h>
+#include "../../../Source/SharedMemoryLayout.h"
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//Usage: SharedMemoryReader <segment name> [--interval ms] [--count updates]
+//
+//Maps a processor's export segment read-only and prints its meters, its
+//newest analysis frame and the level of the newest audio, all read in
+//place. The segment name is shown under the mode box in the plugin's
+//editor and logged when publishing starts. With VERMEULEN_SHARED_MEMORY=1
+//it looks like /VermeulenLadderFilter-1234-0; any other value is used as
+//the name itself, e.g. VERMEULEN_SHARED_MEMORY=bus gives /bus (Local\bus
+//on Windows), which stays the same from one session to the next
+class SharedMemorySegment
+{
+public:
+
+	explicit SharedMemorySegment(const juce::String& name)
+	{
+		const auto totalSize = SharedMemoryLayout::getTotalSize();
+
+#if JUCE_WINDOWS
+		mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, name.toWideCharPointer());
+
+		if (mapping != nullptr)
+		{
+			memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, totalSize);
+		}
+#else
+		fileDescriptor = shm_open(name.toRawUTF8(), O_RDONLY, 0);
+
+		if (fileDescriptor >= 0)
+		{
+			memory = mmap(nullptr, totalSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+			if (memory == MAP_FAILED)
+			{
+				memory = nullptr;
+			}
+		}
+#endif
+	}
+
+	~SharedMemorySegment()
+	{
+#if JUCE_WINDOWS
+		if (memory != nullptr)
+		{
+			UnmapViewOfFile(memory);
+		}
+
+		if (mapping != nullptr)
+		{
+			CloseHandle(mapping);
+		}
+#else
+		if (memory != nullptr)
+		{
+			munmap(memory, SharedMemoryLayout::getTotalSize());
+		}
+
+		if (fileDescriptor >= 0)
+		{
+			close(fileDescriptor);
+		}
+#endif
+	}
+
+	const SharedMemoryLayout::Header* getHeader() const
+	{
+		return static_cast<const SharedMemoryLayout::Header*>(memory);
+	}
+
+	const float* getChannel(int channel) const
+	{
+		auto* bytes = static_cast<const char*>(memory) + SharedMemoryLayout::getAudioOffset();
+		return reinterpret_cast<const float*>(bytes) + static_cast<size_t>(channel) * SharedMemoryLayout::audioCapacity;
+	}
+
+	const SharedMemoryLayout::AnalysisFrame& getFrame(std::uint64_t index) const
+	{
+		auto* bytes = static_cast<const char*>(memory) + SharedMemoryLayout::getAnalysisOffset();
+		return reinterpret_cast<const SharedMemoryLayout::AnalysisFrame*>(bytes)[index % SharedMemoryLayout::analysisCapacity];
+	}
+
+private:
+
+	void* memory{ nullptr };
+
+#if JUCE_WINDOWS
+	void* mapping{ nullptr };
+#else
+	int fileDescriptor{ -1 };
+#endif
+};
+
+static float ToDecibels(float gain)
+{
+	return juce::Decibels::gainToDecibels(gain, -120.0f);
+}
+
+int main(int argc, char* argv[])
+{
+	juce::ArgumentList arguments(argc, argv);
+
+	if (arguments.size() < 1)
+	{
+		std::cout << "Usage: SharedMemoryReader <segment name> [--interval ms] [--count updates]" << std::endl;
+		return 1;
+	}
+
+	auto GetOption = [&arguments](const juce::String& option, int defaultValue)
+	{
+		return arguments.containsOption(option) ? arguments.getValueForOption(option).getIntValue() : defaultValue;
+	};
+
+	const auto name = arguments[0].text;
+	const auto interval = GetOption("--interval", 250);
+	const auto count = GetOption("--count", 0);
+
+	SharedMemorySegment segment(name);
+	const auto* header = segment.getHeader();
+
+	if (header == nullptr)
+	{
+		std::cout << "Could not map " << name << std::endl;
+		return 1;
+	}
+
+	//The writer stores the magic last, once the rest of the header is valid
+	const auto magic = header->magic;
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if (magic != SharedMemoryLayout::magic || header->version != SharedMemoryLayout::version)
+	{
+		std::cout << name << " is not a version " << SharedMemoryLayout::version << " export segment" << std::endl;
+		return 1;
+	}
+
+	const auto numChannels = static_cast<int>(header->numChannels);
+	const auto windowSize = static_cast<std::uint64_t>(header->sampleRate * interval / 1000.0);
+
+	std::cout << name << ": " << numChannels << " channels at " << header->sampleRate << " Hz" << std::endl;
+
+	for (int update = 0; count == 0 || update < count; ++update)
+	{
+		juce::Thread::sleep(interval);
+
+		juce::String line;
+
+		for (int channel = 0; channel < numChannels; ++channel)
+		{
+			line << "ch" << channel << " peak " << juce::String(ToDecibels(header->peak[channel].load()), 1)
+				<< " rms " << juce::String(ToDecibels(header->rms[channel].load()), 1) << " dB  ";
+		}
+
+		//Read the newest frame in place, then make sure the writer has not
+		//lapped it while we were looking
+		const auto frameCount = header->analysisWriteCount.load(std::memory_order_acquire);
+
+		if (frameCount > 0)
+		{
+			const auto index = frameCount - 1;
+			const auto frame = segment.getFrame(index);
+
+			if (header->analysisWriteCount.load(std::memory_order_acquire) < index + SharedMemoryLayout::analysisCapacity)
+			{
+				line << "| mode " << frame.mode << " cutoff " << juce::String(frame.cutoffFrequency, 1)
+					<< " Hz res " << juce::String(frame.resonance, 2) << (frame.isSleeping != 0 ? " sleeping " : " ");
+			}
+		}
+
+		//Measure the audio of the last interval straight from the ring
+		const auto position = header->audioWritePosition.load(std::memory_order_acquire);
+		const auto safeLength = static_cast<std::uint64_t>(SharedMemoryLayout::audioCapacity / 2);
+		const auto length = juce::jmin(juce::jmin(windowSize, position), safeLength);
+
+		if (length > 0)
+		{
+			line << "| window";
+
+			for (int channel = 0; channel < numChannels; ++channel)
+			{
+				const auto* ring = segment.getChannel(channel);
+				auto peak = 0.0f;
+
+				for (auto sample = position - length; sample < position; ++sample)
+				{
+					peak = juce::jmax(peak, std::abs(ring[sample % SharedMemoryLayout::audioCapacity]));
+				}
+
+				line << " " << juce::String(ToDecibels(peak), 1);
+			}
+
+			line << " dB";
+
+			if (header->audioWritePosition.load(std::memory_order_acquire) >= position - length + SharedMemoryLayout::audioCapacity - SharedMemoryLayout::maxBlockSize)
+			{
+				line << " (overrun)";
+			}
+		}
+
+		std::cout << line << std::endl;
+	}
+
+	return 0;
+}
\ No newline at end of file
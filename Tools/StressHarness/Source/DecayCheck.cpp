@@ -0,0 +1,95 @@
+#include "DecayCheck.h"
+
+DecayCheck::DecayCheck(double sampleRate, int blockSize) : HarnessCheck(sampleRate, blockSize)
+{
+}
+
+DecayCheck::Ringing DecayCheck::ringOut(int mode, int numBands, float drive, float resonance)
+{
+	auto processor = createProcessor([numBands](Processor& unprepared) { unprepared.setNumBands(numBands); });
+
+	processor->setMode(mode);
+	processor->setDrive(drive);
+	processor->setResonance(resonance);
+	processor->setCutoffFrequency(cutoffFrequency);
+
+	for (int band = 0; band < numBands; ++band)
+	{
+		processor->setBandMode(band, mode);
+		processor->setBandDrive(band, drive);
+		processor->setBandResonance(band, resonance);
+		processor->setBandCutoffFrequency(band, bandCutoffFrequencies[static_cast<size_t>(band)]);
+	}
+
+	juce::AudioBuffer<float> buffer(2, blockSize);
+	juce::MidiBuffer midiBuffer;
+	Ringing ringing{ 0.0f, 0.0, 0.0, false };
+
+	const auto numBlocks = static_cast<int>(maxSeconds * sampleRate) / blockSize;
+
+	for (int block = 0; block < numBlocks; ++block)
+	{
+		buffer.clear();
+
+		if (block == 0)
+		{
+			buffer.setSample(0, 0, 1.0f);
+			buffer.setSample(1, 0, 1.0f);
+		}
+
+		processor->processBlock(buffer, midiBuffer);
+
+		for (int sample = 0; sample < blockSize; ++sample)
+		{
+			const auto magnitude = juce::jmax(std::abs(buffer.getSample(0, sample)), std::abs(buffer.getSample(1, sample)));
+			ringing.peak = juce::jmax(ringing.peak, magnitude);
+
+			if (magnitude > silenceThreshold)
+			{
+				ringing.lastAudibleSeconds = static_cast<double>(block * blockSize + sample + 1) / sampleRate;
+			}
+		}
+
+		//What the host would have been told while the ladder was ringing
+		if (block == 0)
+		{
+			ringing.tailLengthSeconds = processor->getTailLengthSeconds();
+		}
+	}
+
+	ringing.isSleeping = processor->isSleeping();
+
+	processor->releaseResources();
+	return ringing;
+}
+
+bool DecayCheck::run()
+{
+	const juce::StringArray modeNames{ "LPF12", "HPF12", "BPF12", "LPF24", "HPF24", "BPF24" };
+
+	for (auto numBands : { 1, MultibandLadder::maxBands })
+	{
+		for (auto drive : { 1.0f, 100.0f })
+		{
+			for (auto resonance : { 0.0f, 0.5f, 1.0f })
+			{
+				for (int mode = 0; mode < modeNames.size(); ++mode)
+				{
+					const auto name = modeNames[mode] + ", " + juce::String(numBands) + " band(s), drive "
+						+ juce::String(drive) + ", resonance " + juce::String(resonance) + ": ";
+					const auto ringing = ringOut(mode, numBands, drive, resonance);
+
+					//Make sure there was ringing to die away in the first place
+					check(name + "passes the impulse", ringing.peak > silenceThreshold);
+					check(name + "falls silent within " + juce::String(maxSeconds) + " s",
+						ringing.lastAudibleSeconds < maxSeconds);
+					check(name + "falls silent within the reported tail of " + juce::String(ringing.tailLengthSeconds) + " s",
+						ringing.lastAudibleSeconds <= ringing.tailLengthSeconds);
+					check(name + "goes to sleep", ringing.isSleeping);
+				}
+			}
+		}
+	}
+
+	return hasPassedAll();
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <JuceHeader.h>
+#include "HarnessCheck.h"
+
+//Strikes the ladders with an impulse and checks that the ringing dies away
+//rather than sustaining itself, within the tail length the processor
+//reports, and that the processor then goes to sleep. Covers every mode,
+//up to full resonance, with both the single ladder and the multiband bank
+class DecayCheck : private HarnessCheck
+{
+public:
+
+	DecayCheck(double sampleRate, int blockSize);
+
+	//Returns true when every check passed
+	bool run();
+
+private:
+
+	struct Ringing
+	{
+		float peak;
+		double lastAudibleSeconds;
+		double tailLengthSeconds;
+		bool isSleeping;
+	};
+
+	Ringing ringOut(int mode, int numBands, float drive, float resonance);
+
+	//The processor's sleep threshold
+	const float silenceThreshold{ 1.0e-6f };
+
+	//Full resonance at these cutoffs rings for a few seconds at most
+	const float cutoffFrequency{ 200.0f };
+	const std::array<float, MultibandLadder::maxBands> bandCutoffFrequencies{ { 100.0f, 500.0f, 4000.0f, 12000.0f } };
+	const double maxSeconds{ 10.0 };
+};
\ No newline at end of file
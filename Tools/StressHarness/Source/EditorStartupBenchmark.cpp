@@ -0,0 +1,129 @@
+#include "EditorStartupBenchmark.h"
+#include "StressHarness.h"
+
+EditorStartupBenchmark::EditorStartupBenchmark(double sampleRate, int blockSize)
+	: sampleRate(sampleRate), blockSize(blockSize)
+{
+}
+
+EditorStartupBenchmark::Measurement EditorStartupBenchmark::measureOpen()
+{
+	Measurement measurement;
+
+	auto ElapsedMs = [](juce::int64 start)
+	{
+		return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+	};
+
+	const auto baseBytes = StressHarness::getResidentBytes();
+	auto peakBytes = baseBytes;
+
+	auto start = juce::Time::getHighResolutionTicks();
+	std::unique_ptr<juce::AudioProcessorEditor> editor(processor->createEditorIfNeeded());
+	measurement.constructionMs = ElapsedMs(start);
+
+	editor->addToDesktop(juce::ComponentPeer::windowHasTitleBar);
+	editor->setVisible(true);
+	measurement.showMs = ElapsedMs(start);
+
+	auto* pluginEditor = dynamic_cast<VermeulenLadderFilterAudioProcessorEditor*>(editor.get());
+
+	//The message loop runs in slices of a millisecond, so any slice that
+	//overruns by much was stuck in a single callback, as a host's UI would be
+	while (pluginEditor != nullptr && !pluginEditor->hasRenderedFirstFrame() && ElapsedMs(start) < timeoutMs)
+	{
+		const auto sliceStart = juce::Time::getHighResolutionTicks();
+		juce::MessageManager::getInstance()->runDispatchLoopUntil(1);
+		measurement.longestStallMs = juce::jmax(measurement.longestStallMs, ElapsedMs(sliceStart) - 1.0);
+
+		peakBytes = juce::jmax(peakBytes, StressHarness::getResidentBytes());
+	}
+
+	measurement.firstFrameMs = ElapsedMs(start);
+	measurement.hasRendered = pluginEditor != nullptr && pluginEditor->hasRenderedFirstFrame();
+	measurement.isSoftware = pluginEditor != nullptr && pluginEditor->isUsingSoftwareWaterfall();
+	measurement.peakBytes = peakBytes - baseBytes;
+
+	editor.reset();
+	juce::MessageManager::getInstance()->runDispatchLoopUntil(50);
+
+	return measurement;
+}
+
+void EditorStartupBenchmark::run(int numOpens)
+{
+	processor = std::make_unique<VermeulenLadderFilterAudioProcessor>();
+	processor->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+	processor->prepareToPlay(sampleRate, blockSize);
+
+	//Give the waterfall a block of audio to draw
+	juce::AudioBuffer<float> buffer(2, blockSize);
+	juce::MidiBuffer midiBuffer;
+	juce::Random random;
+
+	for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+	{
+		for (int sample = 0; sample < blockSize; ++sample)
+		{
+			buffer.setSample(channel, sample, random.nextFloat() * 2.0f - 1.0f);
+		}
+	}
+
+	processor->processBlock(buffer, midiBuffer);
+
+	std::vector<Measurement> measurements;
+
+	for (int i = 0; i < numOpens; ++i)
+	{
+		measurements.push_back(measureOpen());
+	}
+
+	processor->releaseResources();
+	processor.reset();
+
+	const auto megabyte = 1024.0 * 1024.0;
+
+	auto Print = [](const char* name, std::vector<double> values, const char* unit)
+	{
+		std::sort(values.begin(), values.end());
+		std::cout << "  " << name << values[values.size() / 2] << " " << unit
+			<< " median, " << values.back() << " " << unit << " max" << std::endl;
+	};
+
+	auto Report = [&Print, megabyte](const char* title, std::vector<Measurement>::const_iterator first,
+		std::vector<Measurement>::const_iterator last)
+	{
+		std::vector<double> construction, show, firstFrame, stall, memory;
+		auto numRendered = 0;
+		auto numSoftware = 0;
+
+		for (auto measurement = first; measurement != last; ++measurement)
+		{
+			construction.push_back(measurement->constructionMs);
+			show.push_back(measurement->showMs);
+			firstFrame.push_back(measurement->firstFrameMs);
+			stall.push_back(measurement->longestStallMs);
+			memory.push_back(measurement->peakBytes / megabyte);
+			numRendered += measurement->hasRendered ? 1 : 0;
+			numSoftware += measurement->isSoftware ? 1 : 0;
+		}
+
+		std::cout << title << ", " << construction.size() << " opens, "
+			<< numRendered << " reached a frame, " << numSoftware << " drawn on the CPU" << std::endl;
+
+		Print("construction:     ", construction, "ms");
+		Print("shown:            ", show, "ms");
+		Print("first frame:      ", firstFrame, "ms");
+		Print("longest UI stall: ", stall, "ms");
+		Print("peak memory:      ", memory, "MB");
+	};
+
+	//The first open also pays for loading the GL driver and compiling shaders.
+	//Setting VERMEULEN_SOFTWARE_WATERFALL measures the CPU waterfall instead
+	Report("First open", measurements.begin(), measurements.begin() + 1);
+
+	if (measurements.size() > 1)
+	{
+		Report("Later opens", measurements.begin() + 1, measurements.end());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../../Source/PluginEditor.h"
+#include "../../../Source/PluginProcessor.h"
+
+//Opens and closes the editor repeatedly, measuring how long each open
+//takes to reach its first rendered frame, the longest the message thread
+//was held up along the way, and how much memory opening it took
+class EditorStartupBenchmark
+{
+public:
+
+	EditorStartupBenchmark(double sampleRate, int blockSize);
+
+	void run(int numOpens);
+
+private:
+
+	struct Measurement
+	{
+		double constructionMs{ 0.0 };
+		double showMs{ 0.0 };
+		double firstFrameMs{ 0.0 };
+		double longestStallMs{ 0.0 };
+		juce::int64 peakBytes{ 0 };
+		bool hasRendered{ false };
+		bool isSoftware{ false };
+	};
+
+	Measurement measureOpen();
+
+	//Frames that take longer than this are reported as never arriving
+	const double timeoutMs{ 10000.0 };
+
+	double sampleRate;
+	int blockSize;
+
+	std::unique_ptr<VermeulenLadderFilterAudioProcessor> processor;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "HarnessCheck.h"
+
+HarnessCheck::HarnessCheck(double sampleRate, int blockSize)
+	: sampleRate(sampleRate), blockSize(blockSize)
+{
+}
+
+std::unique_ptr<HarnessCheck::Processor> HarnessCheck::createProcessor(const std::function<void(Processor&)>& configure) const
+{
+	auto processor = std::make_unique<Processor>();
+
+	if (configure)
+	{
+		configure(*processor);
+	}
+
+	processor->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+	processor->prepareToPlay(sampleRate, blockSize);
+	return processor;
+}
+
+bool HarnessCheck::check(const juce::String& name, bool hasPassed)
+{
+	std::cout << (hasPassed ? "[pass] " : "[FAIL] ") << name << std::endl;
+
+	if (!hasPassed)
+	{
+		++failedChecks;
+	}
+
+	return hasPassed;
+}
+
+bool HarnessCheck::hasPassedAll() const
+{
+	return failedChecks == 0;
+}
\ No newline at end of file
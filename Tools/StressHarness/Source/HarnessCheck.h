@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+//What the harness checks have in common: processors prepared the way a
+//host prepares them, and pass/fail lines whose failures decide the exit code
+class HarnessCheck
+{
+public:
+
+	HarnessCheck(double sampleRate, int blockSize);
+	virtual ~HarnessCheck() = default;
+
+protected:
+
+	using Processor = VermeulenLadderFilterAudioProcessor;
+
+	//Ready for its first block. Settings that only take effect in
+	//prepareToPlay, such as the instruction set, go in configure
+	std::unique_ptr<Processor> createProcessor(const std::function<void(Processor&)>& configure = nullptr) const;
+
+	//Prints the result and counts it if it failed
+	bool check(const juce::String& name, bool hasPassed);
+	bool hasPassedAll() const;
+
+	double sampleRate;
+	int blockSize;
+
+private:
+
+	int failedChecks{ 0 };
+};
\ No newline at end of file
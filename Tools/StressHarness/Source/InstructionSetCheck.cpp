@@ -0,0 +1,164 @@
+#include "InstructionSetCheck.h"
+
+InstructionSetCheck::InstructionSetCheck(double sampleRate, int blockSize) : HarnessCheck(sampleRate, blockSize)
+{
+}
+
+void InstructionSetCheck::checkKernels(InstructionSet instructionSet)
+{
+	const auto& kernels = DspKernels::get(instructionSet);
+	const juce::String name(DspKernels::getName(instructionSet));
+
+	juce::Random random(1);
+	auto hasSameGain = true;
+	auto hasSameSaturation = true;
+	auto hasSamePeak = true;
+	auto hasSameEnergy = true;
+
+	//Every length up to a few registers of the widest set, so that each
+	//variant's tail handling is covered, at every alignment of a float
+	for (int numSamples = 0; numSamples <= 70; ++numSamples)
+	{
+		for (int offset = 0; offset < 4; ++offset)
+		{
+			std::vector<float> input(static_cast<size_t>(numSamples + offset));
+
+			for (auto& sample : input)
+			{
+				sample = (random.nextFloat() * 2.0f - 1.0f) * 1.5f;
+			}
+
+			auto* data = input.data() + offset;
+
+			//The reference is the saturation exactly as the ladder wrote it
+			//before it had kernels
+			const auto driveStart = 1.0f + random.nextFloat() * 99.0f;
+			const auto driveIncrement = (random.nextFloat() - 0.5f) * 0.1f;
+			const auto gainStart = random.nextFloat();
+			const auto gainIncrement = (random.nextFloat() - 0.5f) * 0.01f;
+
+			auto saturated = input;
+			kernels.saturate(saturated.data() + offset, numSamples, driveStart, driveIncrement, gainStart, gainIncrement);
+
+			for (int sample = 0; sample < numSamples; ++sample)
+			{
+				const auto step = static_cast<float>(sample);
+				const auto expected = (gainStart + gainIncrement * step)
+					* juce::dsp::FastMathApproximations::tanh(juce::jlimit(-5.0f, 5.0f,
+						(driveStart + driveIncrement * step) * data[sample]));
+
+				hasSameSaturation = hasSameSaturation && saturated[static_cast<size_t>(sample + offset)] == expected;
+			}
+
+			auto gained = input;
+			kernels.applyGain(gained.data() + offset, numSamples, 0.37f);
+
+			for (int sample = 0; sample < numSamples; ++sample)
+			{
+				hasSameGain = hasSameGain && gained[static_cast<size_t>(sample + offset)] == data[sample] * 0.37f;
+			}
+
+			auto expectedPeak = 0.0f;
+			auto expectedEnergy = 0.0;
+
+			for (int sample = 0; sample < numSamples; ++sample)
+			{
+				expectedPeak = juce::jmax(expectedPeak, std::abs(data[sample]));
+				expectedEnergy += static_cast<double>(data[sample]) * data[sample];
+			}
+
+			auto peak = -1.0f;
+			auto energy = -1.0f;
+			kernels.measurePeakAndEnergy(data, numSamples, &peak, &energy);
+
+			hasSamePeak = hasSamePeak && peak == expectedPeak;
+			hasSameEnergy = hasSameEnergy && std::abs(energy - expectedEnergy) <= energyTolerance * expectedEnergy;
+		}
+	}
+
+	check(name + " gain matches the scalar result exactly", hasSameGain);
+	check(name + " saturation matches the scalar result exactly", hasSameSaturation);
+	check(name + " peak matches the scalar result exactly", hasSamePeak);
+	check(name + " energy matches the scalar result", hasSameEnergy);
+}
+
+std::vector<float> InstructionSetCheck::renderProcessor(InstructionSet instructionSet, int numBands)
+{
+	auto processor = createProcessor([instructionSet, numBands](Processor& unprepared)
+	{
+		unprepared.setInstructionSet(instructionSet);
+		unprepared.setNumBands(numBands);
+	});
+
+	juce::AudioBuffer<float> buffer(2, blockSize);
+	juce::MidiBuffer midiBuffer;
+	std::vector<float> output;
+
+	//The same seed for every set, so each run sees the same input and the
+	//same parameter moves
+	juce::Random random(2);
+
+	for (int block = 0; block < 200; ++block)
+	{
+		if (block % 10 == 0)
+		{
+			processor->setMode(random.nextInt(6));
+			processor->setDrive(1.0f + random.nextFloat() * 99.0f);
+			processor->setVolume(random.nextFloat());
+			processor->setResonance(random.nextFloat());
+			processor->setCutoffFrequency(20.0f + random.nextFloat() * 19980.0f);
+		}
+
+		for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+		{
+			for (int sample = 0; sample < blockSize; ++sample)
+			{
+				buffer.setSample(channel, sample, random.nextFloat() * 2.0f - 1.0f);
+			}
+		}
+
+		processor->processBlock(buffer, midiBuffer);
+
+		for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+		{
+			output.insert(output.end(), buffer.getReadPointer(channel), buffer.getReadPointer(channel) + blockSize);
+		}
+	}
+
+	processor->releaseResources();
+	return output;
+}
+
+bool InstructionSetCheck::run()
+{
+	std::cout << "Best supported: " << DspKernels::getName(DspKernels::getBestSupported()) << std::endl;
+
+	const auto baseline = renderProcessor(InstructionSet::sse2, 1);
+	const auto multibandBaseline = renderProcessor(InstructionSet::sse2, MultibandLadder::maxBands);
+
+	for (auto instructionSet : { InstructionSet::sse2, InstructionSet::avx2, InstructionSet::avx512 })
+	{
+		const juce::String name(DspKernels::getName(instructionSet));
+
+		if (!DspKernels::isSupported(instructionSet))
+		{
+			std::cout << "[skip] " << name << " is not supported on this machine or not built in" << std::endl;
+			continue;
+		}
+
+		checkKernels(instructionSet);
+
+		//Only the meter's energy may differ between sets, and that never
+		//reaches the audio, so the processor output must match to the bit
+		auto processor = createProcessor([instructionSet](Processor& unprepared) { unprepared.setInstructionSet(instructionSet); });
+		check(name + " is selected when forced", processor->getInstructionSet() == instructionSet);
+
+		check(name + " processor output matches sse2", renderProcessor(instructionSet, 1) == baseline);
+		check(name + " multiband processor output matches sse2",
+			renderProcessor(instructionSet, MultibandLadder::maxBands) == multibandBaseline);
+	}
+
+	check("Automatic selects the best supported set", createProcessor()->getInstructionSet() == DspKernels::getBestSupported());
+
+	return hasPassedAll();
+}
\ No newline at end of file
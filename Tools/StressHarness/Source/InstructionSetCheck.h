@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "../../../Source/DspKernels.h"
+#include "HarnessCheck.h"
+
+//Forces each instruction set in turn and checks that its kernels, and a
+//whole processor running on them, give the same output as the SSE2
+//baseline. Sets this machine cannot run are reported and skipped
+class InstructionSetCheck : private HarnessCheck
+{
+public:
+
+	InstructionSetCheck(double sampleRate, int blockSize);
+
+	//Returns true when every check passed
+	bool run();
+
+private:
+
+	void checkKernels(InstructionSet instructionSet);
+	std::vector<float> renderProcessor(InstructionSet instructionSet, int numBands);
+
+	//The sum of squares is added up in a different order on each width
+	const float energyTolerance{ 1.0e-5f };
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <JuceHeader.h>
+#include "DecayCheck.h"
+#include "EditorStartupBenchmark.h"
+#include "InstructionSetCheck.h"
+#include "RealtimeSafetyCheck.h"
+#include "StateCheck.h"
+#include "StressHarness.h"
+
+//Usage: StressHarness [--instances N] [--threads M] [--block samples]
+//                     [--rate Hz] [--seconds s] [--idle fraction] [--editors]
+//       StressHarness --realtime-check [--block samples] [--rate Hz]
+//       StressHarness --state-check
+//       StressHarness --state-load [--instances N]
+//       StressHarness --editor-startup [--opens N]
+//       StressHarness --isa-check [--block samples] [--rate Hz]
+//       StressHarness --decay-check [--block samples] [--rate Hz]
+//
+//The realtime check exits with a non-zero code if processBlock allocated,
+//freed or blocked in any of its steps, the state check if a saved state
+//failed to round-trip or an older one no longer loads, the ISA check if
+//any instruction set's kernels gave different output from SSE2, and the
+//decay check if a ladder kept ringing at full resonance
+int main(int argc, char* argv[])
+{
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+	juce::ArgumentList arguments(argc, argv);
+
+	auto GetOption = [&arguments](const juce::String& option, const juce::String& defaultValue)
+	{
+		return arguments.containsOption(option) ? arguments.getValueForOption(option) : defaultValue;
+	};
+
+	StressHarness::Settings settings;
+	settings.numInstances = juce::jmax(1, GetOption("--instances", juce::String(settings.numInstances)).getIntValue());
+	settings.numThreads = juce::jmax(1, GetOption("--threads", juce::String(settings.numThreads)).getIntValue());
+	settings.blockSize = juce::jmax(1, GetOption("--block", juce::String(settings.blockSize)).getIntValue());
+	settings.sampleRate = juce::jmax(1.0, GetOption("--rate", juce::String(settings.sampleRate)).getDoubleValue());
+	settings.seconds = GetOption("--seconds", juce::String(settings.seconds)).getDoubleValue();
+	settings.idleFraction = GetOption("--idle", juce::String(settings.idleFraction)).getFloatValue();
+	settings.openEditors = arguments.containsOption("--editors");
+
+	if (arguments.containsOption("--realtime-check"))
+	{
+		RealtimeSafetyCheck check(settings.sampleRate, settings.blockSize);
+		return check.run() ? 0 : 1;
+	}
+
+	if (arguments.containsOption("--state-check"))
+	{
+		StateCheck check(settings.sampleRate, settings.blockSize);
+		return check.run() ? 0 : 1;
+	}
+
+	if (arguments.containsOption("--state-load"))
+	{
+		StateCheck check(settings.sampleRate, settings.blockSize);
+		check.measureLoadTime(settings.numInstances);
+		return 0;
+	}
+
+	if (arguments.containsOption("--isa-check"))
+	{
+		InstructionSetCheck check(settings.sampleRate, settings.blockSize);
+		return check.run() ? 0 : 1;
+	}
+
+	if (arguments.containsOption("--decay-check"))
+	{
+		DecayCheck check(settings.sampleRate, settings.blockSize);
+		return check.run() ? 0 : 1;
+	}
+
+	if (arguments.containsOption("--editor-startup"))
+	{
+		EditorStartupBenchmark benchmark(settings.sampleRate, settings.blockSize);
+		benchmark.run(juce::jmax(1, GetOption("--opens", "10").getIntValue()));
+		return 0;
+	}
+
+	StressHarness harness(settings);
+	harness.run();
+	harness.printReport();
+
+	return 0;
+}
\ No newline at end of file
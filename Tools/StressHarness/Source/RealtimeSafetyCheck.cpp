@@ -0,0 +1,142 @@
+#include "RealtimeSafetyCheck.h"
+
+RealtimeSafetyCheck::RealtimeSafetyCheck(double sampleRate, int blockSize) : HarnessCheck(sampleRate, blockSize)
+{
+	buffer.setSize(2, blockSize);
+	midiBuffer.ensureSize(1024);
+}
+
+bool RealtimeSafetyCheck::run()
+{
+#if ! REALTIME_SAFETY_CHECKS
+	std::cout << "Built without REALTIME_SAFETY_CHECKS, nothing can be checked" << std::endl;
+	return false;
+#else
+	//Construction and prepareToPlay are allowed to allocate
+	processor = createProcessor();
+	RealtimeSafety::clearReports();
+
+	processBlocks(100);
+	checkStep("Steady processing");
+
+	for (int i = 0; i < 100; ++i)
+	{
+		processor->setDrive(1.0f + random.nextFloat() * 99.0f);
+		processor->setVolume(random.nextFloat());
+		processor->setResonance(random.nextFloat());
+		processor->setKeytracking(random.nextFloat());
+		processor->setCutoffFrequency(20.0f + random.nextFloat() * 19980.0f);
+		processBlocks(1);
+	}
+
+	checkStep("Parameter changes");
+
+	for (int i = 0; i < 60; ++i)
+	{
+		processor->setMode(i % 6);
+		processBlocks(1);
+	}
+
+	checkStep("Mode switches");
+
+	//Changing the band count resets the crossovers on the audio thread
+	for (int i = 0; i < 100; ++i)
+	{
+		const auto band = random.nextInt(MultibandLadder::maxBands);
+		processor->setNumBands(1 + i % MultibandLadder::maxBands);
+		processor->setCrossoverFrequency(random.nextInt(MultibandLadder::maxBands - 1), 20.0f + random.nextFloat() * 19980.0f);
+		processor->setBandMode(band, random.nextInt(6));
+		processor->setBandDrive(band, 1.0f + random.nextFloat() * 99.0f);
+		processor->setBandResonance(band, random.nextFloat());
+		processor->setBandCutoffFrequency(band, 20.0f + random.nextFloat() * 19980.0f);
+		processBlocks(1);
+	}
+
+	processor->setNumBands(1);
+	checkStep("Multiband");
+
+	for (int i = 0; i < 100; ++i)
+	{
+		midiBuffer.clear();
+		midiBuffer.addEvent(juce::MidiMessage::controllerEvent(1, 74, random.nextInt(128)), random.nextInt(blockSize));
+		midiBuffer.addEvent(juce::MidiMessage::controllerEvent(1, 71, random.nextInt(128)), random.nextInt(blockSize));
+		midiBuffer.addEvent(juce::MidiMessage::noteOn(1, random.nextInt(128), 1.0f), random.nextInt(blockSize));
+		processBlocks(1);
+	}
+
+	midiBuffer.clear();
+	checkStep("MIDI controllers and notes");
+
+	processBlocks(200, true);
+	processBlocks(10);
+	checkStep("Sleep on silence and wake-up");
+
+	//Restoring happens off the audio thread, but the next block must still
+	//take the new values on without allocating
+	juce::MemoryBlock state;
+	processor->getStateInformation(state);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		processor->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+		processBlocks(1);
+	}
+
+	checkStep("State restore");
+
+	std::unique_ptr<juce::AudioProcessorEditor> editor(processor->createEditorIfNeeded());
+	editor->addToDesktop(juce::ComponentPeer::windowHasTitleBar);
+	editor->setVisible(true);
+	processBlocks(200);
+	checkStep("Editor open");
+
+	editor.reset();
+	processBlocks(100);
+	checkStep("Editor closed");
+
+	processor->releaseResources();
+	processor.reset();
+
+	return hasPassedAll();
+#endif
+}
+
+void RealtimeSafetyCheck::processBlocks(int numBlocks, bool isSilent)
+{
+	for (int block = 0; block < numBlocks; ++block)
+	{
+		for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+		{
+			auto* data = buffer.getWritePointer(channel);
+
+			for (int sample = 0; sample < blockSize; sample++)
+			{
+				data[sample] = isSilent ? 0.0f : random.nextFloat() * 2.0f - 1.0f;
+			}
+		}
+
+		processor->processBlock(buffer, midiBuffer);
+
+		//Let an open editor render and react between callbacks
+		if (processor->getActiveEditor() != nullptr)
+		{
+			juce::MessageManager::getInstance()->runDispatchLoopUntil(1);
+		}
+	}
+}
+
+bool RealtimeSafetyCheck::checkStep(const juce::String& name)
+{
+	auto reports = RealtimeSafety::getReports();
+	RealtimeSafety::clearReports();
+
+	check(name, reports.isEmpty());
+
+	for (const auto& report : reports)
+	{
+		std::cout << "  " << RealtimeSafety::getDescription(report.violation)
+			<< " in processBlock, called from:" << std::endl << report.callSite << std::endl;
+	}
+
+	return reports.isEmpty();
+}
\ No newline at end of file
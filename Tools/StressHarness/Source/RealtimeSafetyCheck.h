@@ -0,0 +1,28 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../Source/RealtimeSafety.h"
+#include "HarnessCheck.h"
+
+//Runs one processor through the situations that have allocated or locked
+//on the audio thread before, and fails if any processBlock call does so
+class RealtimeSafetyCheck : private HarnessCheck
+{
+public:
+
+	RealtimeSafetyCheck(double sampleRate, int blockSize);
+
+	//Returns true when no step produced a violation
+	bool run();
+
+private:
+
+	void processBlocks(int numBlocks, bool isSilent = false);
+	bool checkStep(const juce::String& name);
+
+	juce::Random random;
+	juce::AudioBuffer<float> buffer;
+	juce::MidiBuffer midiBuffer;
+
+	std::unique_ptr<Processor> processor;
+};
\ No newline at end of file
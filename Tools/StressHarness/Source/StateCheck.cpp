@@ -0,0 +1,329 @@
+#include "StateCheck.h"
+
+namespace
+{
+	//A version 1 state exactly as the first release of the format writes
+	//it. Later versions must keep loading this to the same values
+	const unsigned char versionOneState[] =
+	{
+		0x56, 0x4c, 0x46, 0x50, 0x01, 0x00, 0x28, 0x00,   //Header, 40 byte payload
+		0x01, 0x00, 0x00, 0x00,                           //Mode: HPF12
+		0x00, 0x00, 0x20, 0x41,                           //Drive: 10
+		0x00, 0x00, 0x80, 0x3e,                           //Volume: 0.25
+		0x00, 0x00, 0x00, 0x3f,                           //Resonance: 0.5
+		0x00, 0x00, 0x80, 0x3f,                           //Keytracking: 1
+		0x00, 0x00, 0x7a, 0x44,                           //Cutoff: 1000 Hz
+		0x14, 0x00, 0x00, 0x00,                           //History: 20
+		0x00, 0x00, 0x00, 0x3f,                           //Camera x: 0.5
+		0x00, 0x00, 0x00, 0x00,                           //Camera y: 0
+		0x00, 0x00, 0x00, 0x40                            //Camera z: 2
+	};
+}
+
+StateCheck::StateCheck(double sampleRate, int blockSize) : HarnessCheck(sampleRate, blockSize)
+{
+}
+
+void StateCheck::randomise(Processor& processor)
+{
+	processor.setMode(random.nextInt(6));
+	processor.setDrive(1.0f + random.nextFloat() * 99.0f);
+	processor.setVolume(random.nextFloat());
+	processor.setResonance(random.nextFloat());
+	processor.setKeytracking(random.nextFloat());
+	processor.setCutoffFrequency(20.0f + random.nextFloat() * 19980.0f);
+	processor.setEditorHistory(1 + random.nextInt(1000));
+	processor.setEditorCamera({ random.nextFloat() - 0.5f, random.nextFloat(), random.nextFloat() * 10.0f });
+
+	processor.setNumBands(1 + random.nextInt(MultibandLadder::maxBands));
+
+	for (int i = 0; i < MultibandLadder::maxBands - 1; ++i)
+	{
+		processor.setCrossoverFrequency(i, 20.0f + random.nextFloat() * 19980.0f);
+	}
+
+	for (int band = 0; band < MultibandLadder::maxBands; ++band)
+	{
+		processor.setBandMode(band, random.nextInt(6));
+		processor.setBandDrive(band, 1.0f + random.nextFloat() * 99.0f);
+		processor.setBandResonance(band, random.nextFloat());
+		processor.setBandCutoffFrequency(band, 20.0f + random.nextFloat() * 19980.0f);
+	}
+}
+
+bool StateCheck::hasSameState(const Processor& first, const Processor& second) const
+{
+	auto haveSameBands = first.getNumBands() == second.getNumBands();
+
+	for (int i = 0; i < MultibandLadder::maxBands - 1; ++i)
+	{
+		haveSameBands = haveSameBands && first.getCrossoverFrequency(i) == second.getCrossoverFrequency(i);
+	}
+
+	for (int band = 0; band < MultibandLadder::maxBands; ++band)
+	{
+		haveSameBands = haveSameBands
+			&& first.getBandMode(band) == second.getBandMode(band)
+			&& first.getBandDrive(band) == second.getBandDrive(band)
+			&& first.getBandResonance(band) == second.getBandResonance(band)
+			&& first.getBandCutoffFrequency(band) == second.getBandCutoffFrequency(band);
+	}
+
+	return haveSameBands
+		&& first.getMode() == second.getMode()
+		&& first.getDrive() == second.getDrive()
+		&& first.getVolume() == second.getVolume()
+		&& first.getResonance() == second.getResonance()
+		&& first.getKeytracking() == second.getKeytracking()
+		&& first.getCutoffFrequency() == second.getCutoffFrequency()
+		&& first.getEditorHistory() == second.getEditorHistory()
+		&& first.getEditorCamera().x == second.getEditorCamera().x
+		&& first.getEditorCamera().y == second.getEditorCamera().y
+		&& first.getEditorCamera().z == second.getEditorCamera().z;
+}
+
+bool StateCheck::run()
+{
+	auto source = createProcessor();
+	auto defaults = createProcessor();
+
+	juce::MemoryBlock state;
+	source->getStateInformation(state);
+	check("State fits in 128 bytes", state.getSize() <= 128);
+
+	auto restored = createProcessor();
+	randomise(*restored);
+	restored->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+	check("Default state round-trips", hasSameState(*restored, *defaults));
+
+	auto allRoundTrip = true;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		randomise(*source);
+		source->getStateInformation(state);
+		restored->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+		allRoundTrip = allRoundTrip && hasSameState(*source, *restored);
+	}
+
+	check("Random states round-trip", allRoundTrip);
+
+	//Earlier builds saved nothing at all, which must leave a processor as it is
+	restored->setStateInformation(nullptr, 0);
+	check("Empty state from earlier builds is ignored", hasSameState(*source, *restored));
+
+	const char notOurs[] = "<?xml version=\"1.0\"?><PARAMS/>";
+	restored->setStateInformation(notOurs, static_cast<int>(sizeof(notOurs)));
+	check("Foreign data is ignored", hasSameState(*source, *restored));
+
+	auto golden = createProcessor();
+	golden->setStateInformation(versionOneState, static_cast<int>(sizeof(versionOneState)));
+	check("Version 1 state loads", golden->getMode() == 1
+		&& golden->getDrive() == 10.0f
+		&& golden->getVolume() == 0.25f
+		&& golden->getResonance() == 0.5f
+		&& golden->getKeytracking() == 1.0f
+		&& golden->getCutoffFrequency() == 1000.0f
+		&& golden->getEditorHistory() == 20
+		&& golden->getEditorCamera().x == 0.5f
+		&& golden->getEditorCamera().y == 0.0f
+		&& golden->getEditorCamera().z == 2.0f);
+
+	check("Version 1 state keeps a single band", golden->getNumBands() == 1
+		&& golden->getCrossoverFrequency(0) == defaults->getCrossoverFrequency(0)
+		&& golden->getBandCutoffFrequency(0) == defaults->getBandCutoffFrequency(0));
+
+	//Version 2 only appends, so everything a version 1 reader looks at is
+	//still where it was
+	juce::MemoryBlock goldenState;
+	golden->getStateInformation(goldenState);
+	const auto* goldenBytes = static_cast<const unsigned char*>(goldenState.getData());
+	check("Version 2 state starts with the version 1 layout", goldenState.getSize() > sizeof(versionOneState)
+		&& std::memcmp(goldenBytes, versionOneState, 4) == 0
+		&& goldenBytes[4] == 2
+		&& std::memcmp(goldenBytes + 8, versionOneState + 8, sizeof(versionOneState) - 8) == 0);
+
+	//A shorter payload, as a writer with fewer fields would produce, sets
+	//what it has and keeps the defaults for the rest
+	juce::MemoryBlock shorter(versionOneState, sizeof(versionOneState));
+	static_cast<unsigned char*>(shorter.getData())[6] = 24;
+	shorter.setSize(8 + 24);
+
+	auto partial = createProcessor();
+	partial->setStateInformation(shorter.getData(), static_cast<int>(shorter.getSize()));
+	check("Shorter payload keeps later defaults", partial->getCutoffFrequency() == 1000.0f
+		&& partial->getEditorHistory() == defaults->getEditorHistory()
+		&& partial->getEditorCamera().z == defaults->getEditorCamera().z);
+
+	//Fields are only read as far as the data's version goes, so a version 1
+	//header leaves the bands alone whatever follows it
+	auto multiband = createProcessor();
+	randomise(*multiband);
+	juce::MemoryBlock relabelled;
+	multiband->getStateInformation(relabelled);
+	static_cast<unsigned char*>(relabelled.getData())[4] = 1;
+
+	auto older = createProcessor();
+	older->setStateInformation(relabelled.getData(), static_cast<int>(relabelled.getSize()));
+	check("Version 1 data reads no band fields", older->getDrive() == multiband->getDrive()
+		&& older->getNumBands() == defaults->getNumBands()
+		&& older->getBandCutoffFrequency(0) == defaults->getBandCutoffFrequency(0));
+
+	//A newer writer may have changed what the fields mean, so its data is
+	//left alone rather than half understood
+	juce::MemoryBlock newer;
+	multiband->getStateInformation(newer);
+
+	const unsigned char extraFields[] = { 0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04 };
+	newer.append(extraFields, sizeof(extraFields));
+	static_cast<unsigned char*>(newer.getData())[4] = 7;
+	static_cast<unsigned char*>(newer.getData())[6] = static_cast<unsigned char>(newer.getSize() - 8);
+
+	auto future = createProcessor();
+	future->setStateInformation(newer.getData(), static_cast<int>(newer.getSize()));
+	check("Newer state is rejected", hasSameState(*future, *defaults));
+
+	//Corrupt or hostile values are clamped rather than applied
+	juce::MemoryBlock corrupt(versionOneState, sizeof(versionOneState));
+	auto* corruptBytes = static_cast<unsigned char*>(corrupt.getData());
+	corruptBytes[8] = 0x7f;    //Mode 127
+	corruptBytes[14] = 0xc0;   //Drive NaN
+	corruptBytes[15] = 0x7f;
+	corruptBytes[31] = 0x7f;   //Cutoff around 3e38 Hz
+	corruptBytes[35] = 0x80;   //Negative history
+
+	auto clamped = createProcessor();
+	clamped->setStateInformation(corrupt.getData(), static_cast<int>(corrupt.getSize()));
+	check("Out-of-range and NaN values are made safe", clamped->getMode() == 5
+		&& clamped->getDrive() == defaults->getDrive()
+		&& clamped->getCutoffFrequency() == 24000.0f
+		&& clamped->getEditorHistory() == 1);
+
+	//Restoring while another thread keeps processing must neither block
+	//nor disturb it, and the last state restored must win
+	std::atomic<bool> isProcessing{ true };
+	auto running = createProcessor();
+
+	std::thread audioThread([&running, &isProcessing, this]
+	{
+		juce::AudioBuffer<float> buffer(2, blockSize);
+		juce::MidiBuffer midiBuffer;
+		juce::Random noise;
+
+		while (isProcessing)
+		{
+			for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+			{
+				for (int sample = 0; sample < blockSize; ++sample)
+				{
+					buffer.setSample(channel, sample, noise.nextFloat() * 2.0f - 1.0f);
+				}
+			}
+
+			running->processBlock(buffer, midiBuffer);
+		}
+	});
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		randomise(*source);
+		source->getStateInformation(state);
+		running->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+	}
+
+	isProcessing = false;
+	audioThread.join();
+
+	check("States restore while audio is running", hasSameState(*source, *running));
+
+	return hasPassedAll();
+}
+
+void StateCheck::measureLoadTime(int numInstances)
+{
+	std::vector<std::unique_ptr<Processor>> processors;
+
+	for (int i = 0; i < numInstances; ++i)
+	{
+		processors.push_back(createProcessor());
+		randomise(*processors.back());
+	}
+
+	//Each instance gets a state of its own, as in a real project
+	std::vector<juce::MemoryBlock> states(static_cast<size_t>(numInstances));
+	std::vector<juce::MemoryBlock> xmlStates(static_cast<size_t>(numInstances));
+
+	auto start = juce::Time::getHighResolutionTicks();
+
+	for (int i = 0; i < numInstances; ++i)
+	{
+		processors[static_cast<size_t>(i)]->getStateInformation(states[static_cast<size_t>(i)]);
+	}
+
+	const auto saveTicks = juce::Time::getHighResolutionTicks() - start;
+
+	start = juce::Time::getHighResolutionTicks();
+
+	for (int i = 0; i < numInstances; ++i)
+	{
+		const auto& state = states[static_cast<size_t>(i)];
+		processors[static_cast<size_t>(i)]->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+	}
+
+	const auto loadTicks = juce::Time::getHighResolutionTicks() - start;
+
+	//For comparison, the same values through the usual XML round-trip
+	for (int i = 0; i < numInstances; ++i)
+	{
+		auto& processor = *processors[static_cast<size_t>(i)];
+
+		juce::XmlElement xml("VermeulenLadderFilter");
+		xml.setAttribute("mode", processor.getMode());
+		xml.setAttribute("drive", processor.getDrive());
+		xml.setAttribute("volume", processor.getVolume());
+		xml.setAttribute("resonance", processor.getResonance());
+		xml.setAttribute("keytracking", processor.getKeytracking());
+		xml.setAttribute("cutoffFrequency", processor.getCutoffFrequency());
+		xml.setAttribute("history", processor.getEditorHistory());
+		xml.setAttribute("cameraX", processor.getEditorCamera().x);
+		xml.setAttribute("cameraY", processor.getEditorCamera().y);
+		xml.setAttribute("cameraZ", processor.getEditorCamera().z);
+
+		juce::AudioProcessor::copyXmlToBinary(xml, xmlStates[static_cast<size_t>(i)]);
+	}
+
+	start = juce::Time::getHighResolutionTicks();
+	auto checksum = 0.0;
+
+	for (int i = 0; i < numInstances; ++i)
+	{
+		const auto& state = xmlStates[static_cast<size_t>(i)];
+
+		if (auto xml = juce::AudioProcessor::getXmlFromBinary(state.getData(), static_cast<int>(state.getSize())))
+		{
+			checksum += xml->getIntAttribute("mode") + xml->getDoubleAttribute("drive")
+				+ xml->getDoubleAttribute("volume") + xml->getDoubleAttribute("resonance")
+				+ xml->getDoubleAttribute("keytracking") + xml->getDoubleAttribute("cutoffFrequency")
+				+ xml->getIntAttribute("history") + xml->getDoubleAttribute("cameraX")
+				+ xml->getDoubleAttribute("cameraY") + xml->getDoubleAttribute("cameraZ");
+		}
+	}
+
+	const auto xmlTicks = juce::Time::getHighResolutionTicks() - start;
+
+	auto ToMicroseconds = [](juce::int64 ticks)
+	{
+		return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+	};
+
+	std::cout << "State load, " << numInstances << " instances" << std::endl;
+	std::cout << "  binary state:  " << states.front().getSize() << " bytes" << std::endl;
+	std::cout << "  save:          " << ToMicroseconds(saveTicks) / 1000.0 << " ms total, "
+		<< ToMicroseconds(saveTicks) / numInstances << " us per instance" << std::endl;
+	std::cout << "  load:          " << ToMicroseconds(loadTicks) / 1000.0 << " ms total, "
+		<< ToMicroseconds(loadTicks) / numInstances << " us per instance" << std::endl;
+	std::cout << "  XML for scale: " << xmlStates.front().getSize() << " bytes, "
+		<< ToMicroseconds(xmlTicks) / numInstances << " us per instance to parse" << std::endl;
+
+	juce::ignoreUnused(checksum);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <JuceHeader.h>
+#include "HarnessCheck.h"
+
+//Round-trip and backward-compatibility checks for the saved state, plus a
+//measurement of how long restoring it takes across many instances
+class StateCheck : private HarnessCheck
+{
+public:
+
+	StateCheck(double sampleRate, int blockSize);
+
+	//Returns true when every check passed
+	bool run();
+
+	void measureLoadTime(int numInstances);
+
+private:
+
+	void randomise(Processor& processor);
+	bool hasSameState(const Processor& first, const Processor& second) const;
+
+	juce::Random random;
+};
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "StressHarness.h"
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif JUCE_LINUX
+#include <unistd.h>
+#endif
+
+StressHarness::StressHarness(const Settings& settings) : settings(settings)
+{
+	//One second of noise that every active instance reads its input from,
+	//or more when the blocks are so long that offsets could not vary
+	const auto signalLength = juce::jmax(static_cast<int>(settings.sampleRate), settings.blockSize * 2);
+	juce::Random random;
+
+	signal.setSize(2, signalLength);
+
+	for (int channel = 0; channel < signal.getNumChannels(); ++channel)
+	{
+		auto* data = signal.getWritePointer(channel);
+
+		for (int sample = 0; sample < signalLength; sample++)
+		{
+			data[sample] = random.nextFloat() * 2.0f - 1.0f;
+		}
+	}
+}
+
+StressHarness::~StressHarness()
+{
+	closeEditors();
+}
+
+juce::int64 StressHarness::getResidentBytes()
+{
+#if JUCE_WINDOWS
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return static_cast<juce::int64>(counters.WorkingSetSize);
+	}
+
+	return 0;
+#elif JUCE_LINUX
+	long totalPages = 0;
+	long residentPages = 0;
+
+	if (auto* file = fopen("/proc/self/statm", "r"))
+	{
+		if (fscanf(file, "%ld %ld", &totalPages, &residentPages) != 2)
+		{
+			residentPages = 0;
+		}
+
+		fclose(file);
+	}
+
+	return static_cast<juce::int64>(residentPages) * sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+void StressHarness::createInstances()
+{
+	baseResidentBytes = getResidentBytes();
+
+	const auto numIdle = static_cast<int>(settings.numInstances * settings.idleFraction);
+
+	instances.resize(static_cast<size_t>(settings.numInstances));
+
+	for (int i = 0; i < settings.numInstances; ++i)
+	{
+		auto& instance = instances[static_cast<size_t>(i)];
+
+		instance.processor = std::make_unique<VermeulenLadderFilterAudioProcessor>();
+		instance.processor->setPlayConfigDetails(2, 2, settings.sampleRate, settings.blockSize);
+		instance.processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+
+		//The editor normally pushes these on construction
+		instance.processor->setDrive(1.0f);
+		instance.processor->setVolume(0.5f);
+		instance.processor->setResonance(0.5f);
+		instance.processor->setCutoffFrequency(1000.0f);
+
+		instance.buffer.setSize(2, settings.blockSize);
+		instance.midiBuffer.ensureSize(256);
+		instance.isIdle = i < numIdle;
+	}
+
+	instancesResidentBytes = getResidentBytes();
+}
+
+void StressHarness::openEditors()
+{
+	for (auto& instance : instances)
+	{
+		instance.editor.reset(instance.processor->createEditorIfNeeded());
+		instance.editor->addToDesktop(juce::ComponentPeer::windowHasTitleBar);
+		instance.editor->setVisible(true);
+	}
+
+	editorsResidentBytes = getResidentBytes();
+}
+
+void StressHarness::closeEditors()
+{
+	for (auto& instance : instances)
+	{
+		instance.editor.reset();
+	}
+}
+
+void StressHarness::run()
+{
+	createInstances();
+
+	if (settings.openEditors)
+	{
+		openEditors();
+	}
+
+	//The calling thread processes alongside the workers, as a host's
+	//audio thread would, so M threads means M - 1 extra workers
+	for (int i = 1; i < settings.numThreads; ++i)
+	{
+		workers.emplace_back([this] { workerLoop(); });
+	}
+
+	std::thread driver([this] { driverLoop(); });
+
+	//Editors need the message thread to keep running while audio is driven
+	if (settings.openEditors)
+	{
+		juce::MessageManager::getInstance()->runDispatchLoopUntil(
+			static_cast<int>(settings.seconds * 1000.0) + 500);
+	}
+
+	driver.join();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isQuitting = true;
+	}
+
+	wakeWorkers.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	workers.clear();
+	closeEditors();
+}
+
+void StressHarness::driverLoop()
+{
+	using Clock = std::chrono::steady_clock;
+
+	const auto period = std::chrono::duration<double>(settings.blockSize / settings.sampleRate);
+	const auto numCallbacks = static_cast<int>(settings.seconds * settings.sampleRate / settings.blockSize);
+
+	callbackTimes.clear();
+	callbackTimes.reserve(static_cast<size_t>(numCallbacks));
+
+	auto start = Clock::now();
+	auto deadline = start;
+
+	for (int callback = 0; callback < numCallbacks; ++callback)
+	{
+		auto callbackStart = juce::Time::getHighResolutionTicks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			nextInstance = 0;
+			pendingWorkers = static_cast<int>(workers.size());
+			++generation;
+		}
+
+		wakeWorkers.notify_all();
+		processInstances();
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			workersDone.wait(lock, [this] { return pendingWorkers == 0; });
+		}
+
+		callbackTimes.push_back(juce::Time::highResolutionTicksToSeconds(
+			juce::Time::getHighResolutionTicks() - callbackStart));
+
+		//Pace the callbacks in real time like an audio device would, but
+		//start the next one immediately if this one overran its deadline
+		deadline += std::chrono::duration_cast<Clock::duration>(period);
+		std::this_thread::sleep_until(deadline);
+	}
+
+	wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	if (settings.openEditors)
+	{
+		juce::MessageManager::getInstance()->stopDispatchLoop();
+	}
+}
+
+void StressHarness::workerLoop()
+{
+	auto seenGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeWorkers.wait(lock, [&] { return isQuitting || generation != seenGeneration; });
+
+			if (isQuitting)
+			{
+				return;
+			}
+
+			seenGeneration = generation;
+		}
+
+		processInstances();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (--pendingWorkers == 0)
+			{
+				workersDone.notify_one();
+			}
+		}
+	}
+}
+
+void StressHarness::processInstances()
+{
+	auto startTicks = juce::Time::getHighResolutionTicks();
+
+	for (int index = nextInstance++; index < settings.numInstances; index = nextInstance++)
+	{
+		auto& instance = instances[static_cast<size_t>(index)];
+
+		//Stagger the read position so instances do not all see the same input
+		auto signalPosition = (index * 97) % (signal.getNumSamples() - settings.blockSize);
+
+		for (int channel = 0; channel < 2; ++channel)
+		{
+			if (instance.isIdle)
+			{
+				instance.buffer.clear(channel, 0, settings.blockSize);
+			}
+
+			else
+			{
+				instance.buffer.copyFrom(channel, 0, signal, channel, signalPosition, settings.blockSize);
+			}
+		}
+
+		instance.processor->processBlock(instance.buffer, instance.midiBuffer);
+	}
+
+	busyTicks += juce::Time::getHighResolutionTicks() - startTicks;
+}
+
+void StressHarness::printReport() const
+{
+	if (callbackTimes.empty())
+	{
+		std::cout << "No callbacks were run" << std::endl;
+		return;
+	}
+
+	auto sortedTimes = callbackTimes;
+	std::sort(sortedTimes.begin(), sortedTimes.end());
+
+	const auto deadline = settings.blockSize / settings.sampleRate;
+	const auto percentile = [&sortedTimes](double fraction)
+	{
+		auto index = static_cast<size_t>(fraction * (sortedTimes.size() - 1));
+		return sortedTimes[index] * 1000.0;
+	};
+
+	const auto misses = std::count_if(sortedTimes.begin(), sortedTimes.end(),
+		[deadline](double time) { return time > deadline; });
+
+	const auto busySeconds = juce::Time::highResolutionTicksToSeconds(busyTicks.load());
+	const auto megabyte = 1024.0 * 1024.0;
+
+	std::cout << "Instances: " << settings.numInstances
+		<< " (" << static_cast<int>(settings.numInstances * settings.idleFraction) << " idle)"
+		<< ", threads: " << settings.numThreads
+		<< ", block: " << settings.blockSize
+		<< " @ " << settings.sampleRate << " Hz"
+		<< (settings.openEditors ? ", editors open" : "") << std::endl;
+
+	std::cout << "Callbacks: " << sortedTimes.size()
+		<< ", deadline: " << deadline * 1000.0 << " ms" << std::endl;
+
+	std::cout << "Callback time p50: " << percentile(0.5)
+		<< " ms, p99: " << percentile(0.99)
+		<< " ms, max: " << percentile(1.0) << " ms" << std::endl;
+
+	std::cout << "Deadline misses: " << misses
+		<< " (" << 100.0 * misses / sortedTimes.size() << "%)" << std::endl;
+
+	std::cout << "Total CPU: " << busySeconds / wallSeconds << " cores busy, "
+		<< 100.0 * busySeconds / (wallSeconds * settings.numThreads) << "% of the pool" << std::endl;
+
+	std::cout << "Memory per instance: "
+		<< (instancesResidentBytes - baseResidentBytes) / megabyte / settings.numInstances << " MB";
+
+	if (settings.openEditors)
+	{
+		std::cout << ", per editor: "
+			<< (editorsResidentBytes - instancesResidentBytes) / megabyte / settings.numInstances << " MB";
+	}
+
+	std::cout << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+//Drives many processor instances from a pool of worker threads the way a
+//host's parallel graph would, and reports how the audio callback copes
+class StressHarness
+{
+public:
+
+	struct Settings
+	{
+		int numInstances{ 200 };
+		int numThreads{ 4 };
+		int blockSize{ 256 };
+		double sampleRate{ 48000.0 };
+		double seconds{ 10.0 };
+		float idleFraction{ 0.0f };
+		bool openEditors{ false };
+	};
+
+	StressHarness(const Settings& settings);
+	~StressHarness();
+
+	void run();
+	void printReport() const;
+
+	//Current resident memory of the whole process, or 0 where unknown
+	static juce::int64 getResidentBytes();
+
+private:
+
+	struct Instance
+	{
+		std::unique_ptr<VermeulenLadderFilterAudioProcessor> processor;
+		std::unique_ptr<juce::AudioProcessorEditor> editor;
+		juce::AudioBuffer<float> buffer;
+		juce::MidiBuffer midiBuffer;
+		bool isIdle{ false };
+	};
+
+	void createInstances();
+	void openEditors();
+	void closeEditors();
+
+	void driverLoop();
+	void workerLoop();
+	void processInstances();
+
+	Settings settings;
+
+	juce::AudioBuffer<float> signal;
+	std::vector<Instance> instances;
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable wakeWorkers;
+	std::condition_variable workersDone;
+
+	bool isQuitting{ false };
+	int generation{ 0 };
+	int pendingWorkers{ 0 };
+	std::atomic<int> nextInstance{ 0 };
+	std::atomic<juce::int64> busyTicks{ 0 };
+
+	std::vector<double> callbackTimes;
+
+	double wallSeconds{ 0.0 };
+	juce::int64 baseResidentBytes{ 0 };
+	juce::int64 instancesResidentBytes{ 0 };
+	juce::int64 editorsResidentBytes{ 0 };
+};
\ No newline at end of file